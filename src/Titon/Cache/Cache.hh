@@ -9,6 +9,7 @@ namespace Titon\Cache;
 
 use Titon\Cache\Exception\MissingStorageException;
 use Titon\Cache\Storage;
+use Titon\Utility\OptionMap;
 
 /**
  * Provides a very basic interface for caching individual sets of data. Multiple storage engines can be setup
@@ -69,6 +70,43 @@ class Cache {
         return true;
     }
 
+    /**
+     * Asynchronously get data from the storage engine defined by the key.
+     *
+     * @param string $key
+     * @param string $storage
+     * @return Awaitable<\Titon\Cache\Item>
+     */
+    public async function genGet(string $key, string $storage = 'default'): Awaitable<Item> {
+        return await $this->getStorage($storage)->genGetItem($key);
+    }
+
+    /**
+     * Asynchronously get multiple items from the storage engine defined by the key.
+     *
+     * @param array<string> $keys
+     * @param string $storage
+     * @return Awaitable<\Titon\Cache\ItemMap>
+     */
+    public async function genGetItems(array<string> $keys, string $storage = 'default'): Awaitable<ItemMap> {
+        return await $this->getStorage($storage)->genGetItems($keys);
+    }
+
+    /**
+     * Asynchronously set data to the defined storage engine.
+     *
+     * @param string $key
+     * @param mixed $value
+     * @param mixed $expires
+     * @param string $storage
+     * @return Awaitable<bool>
+     */
+    public async function genSet(string $key, mixed $value, mixed $expires = null, string $storage = 'default'): Awaitable<bool> {
+        await $this->getStorage($storage)->genSave(new Item($key, $value, $expires));
+
+        return true;
+    }
+
     /**
      * Get data from the storage engine defined by the key.
      *
@@ -171,10 +209,11 @@ class Cache {
      * @param \Titon\Cache\CacheCallback $callback
      * @param mixed $expires
      * @param string $storage
+     * @param \Titon\Utility\OptionMap $options
      * @return mixed
      */
-    public function store(string $key, CacheCallback $callback, mixed $expires = null, string $storage = 'default'): mixed {
-        return $this->getStorage($storage)->store($key, $callback, $expires);
+    public function store(string $key, CacheCallback $callback, mixed $expires = null, string $storage = 'default', OptionMap $options = Map {}): mixed {
+        return $this->getStorage($storage)->store($key, $callback, $expires, $options);
     }
 
 }
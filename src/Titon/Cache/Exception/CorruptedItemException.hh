@@ -0,0 +1,17 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Exception;
+
+/**
+ * Exception thrown when cached data cannot be decoded.
+ *
+ * @package Titon\Cache\Exception
+ */
+class CorruptedItemException extends \RuntimeException {
+
+}
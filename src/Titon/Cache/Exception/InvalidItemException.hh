@@ -0,0 +1,17 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Exception;
+
+/**
+ * Exception thrown when an item cannot be updated, like incrementing a value that is not numeric.
+ *
+ * @package Titon\Cache\Exception
+ */
+class InvalidItemException extends \RuntimeException {
+
+}
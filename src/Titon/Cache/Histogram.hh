@@ -0,0 +1,166 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache;
+
+/**
+ * A latency histogram with logarithmic buckets, where each bucket holds durations up to twice the previous bucket,
+ * starting at 1 microsecond. Memory usage is constant regardless of the number of recorded durations,
+ * and percentiles are accurate to within a factor of 2.
+ *
+ * @package Titon\Cache
+ */
+class Histogram {
+
+    /**
+     * Number of buckets, which covers durations up to 2^31 microseconds.
+     */
+    const int BUCKETS = 32;
+
+    /**
+     * Number of durations in each bucket.
+     *
+     * @var Vector<int>
+     */
+    protected Vector<int> $buckets;
+
+    /**
+     * Number of recorded durations.
+     *
+     * @var int
+     */
+    protected int $count = 0;
+
+    /**
+     * Longest recorded duration in seconds.
+     *
+     * @var float
+     */
+    protected float $max = 0.0;
+
+    /**
+     * Sum of all recorded durations in seconds.
+     *
+     * @var float
+     */
+    protected float $sum = 0.0;
+
+    /**
+     * Initialize the buckets.
+     */
+    public function __construct() {
+        $this->buckets = Vector {};
+        $this->reset();
+    }
+
+    /**
+     * Record a duration in seconds.
+     *
+     * @param float $seconds
+     * @return $this
+     */
+    public function add(float $seconds): this {
+        $micro = $seconds * 1000000;
+        $index = ($micro <= 1) ? 0 : min(self::BUCKETS - 1, (int) ceil(log($micro, 2)));
+
+        $this->buckets[$index]++;
+        $this->count++;
+        $this->sum += $seconds;
+        $this->max = max($this->max, $seconds);
+
+        return $this;
+    }
+
+    /**
+     * Return the number of recorded durations.
+     *
+     * @return int
+     */
+    public function getCount(): int {
+        return $this->count;
+    }
+
+    /**
+     * Return the longest recorded duration in seconds.
+     *
+     * @return float
+     */
+    public function getMax(): float {
+        return $this->max;
+    }
+
+    /**
+     * Return the average duration in seconds.
+     *
+     * @return float
+     */
+    public function getMean(): float {
+        return $this->count ? ($this->sum / $this->count) : 0.0;
+    }
+
+    /**
+     * Return the duration in seconds that the defined percent of durations are less than or equal to.
+     * The upper bound of the matching bucket is returned, capped by the longest recorded duration.
+     *
+     * @param float $percent
+     * @return float
+     */
+    public function percentile(float $percent): float {
+        if (!$this->count) {
+            return 0.0;
+        }
+
+        $rank = max(1, (int) ceil($this->count * $percent / 100));
+        $total = 0;
+
+        foreach ($this->buckets as $index => $count) {
+            $total += $count;
+
+            if ($total >= $rank) {
+                return min(pow(2, $index) / 1000000, $this->max);
+            }
+        }
+
+        return $this->max;
+    }
+
+    /**
+     * Remove all recorded durations.
+     *
+     * @return $this
+     */
+    public function reset(): this {
+        $this->buckets->clear();
+
+        for ($i = 0; $i < self::BUCKETS; $i++) {
+            $this->buckets[] = 0;
+        }
+
+        $this->count = 0;
+        $this->max = 0.0;
+        $this->sum = 0.0;
+
+        return $this;
+    }
+
+    /**
+     * Return the count, and the mean, max, and 50th, 95th, and 99th percentile durations in milliseconds.
+     *
+     * @return Map<string, num>
+     */
+    public function toMap(): Map<string, num> {
+        return Map {
+            'count' => $this->getCount(),
+            'mean' => round($this->getMean() * 1000, 3),
+            'max' => round($this->getMax() * 1000, 3),
+            'p50' => round($this->percentile(50.0) * 1000, 3),
+            'p95' => round($this->percentile(95.0) * 1000, 3),
+            'p99' => round($this->percentile(99.0) * 1000, 3)
+        };
+    }
+
+}
@@ -33,6 +33,13 @@ class Item {
      */
     protected string $key = '';
 
+    /**
+     * Tags that group this item with other items, so that they can be invalidated together.
+     *
+     * @var array<string>
+     */
+    protected array<string> $tags = [];
+
     /**
      * The items value to be saved.
      *
@@ -109,6 +116,15 @@ class Item {
         return $this->key;
     }
 
+    /**
+     * Return the tags for the current cache item.
+     *
+     * @return array<string>
+     */
+    public function getTags(): array<string> {
+        return $this->tags;
+    }
+
     /**
      * Confirms if the cache item lookup resulted in a cache hit.
      *
@@ -186,4 +202,20 @@ class Item {
         return $this;
     }
 
+    /**
+     * Set the tags for the current cache item. When saved, the item is stored under the
+     * versioned namespace of its tags, and must be read through `Storage::tagged()` with the same tags.
+     *
+     * @param array<string> $tags
+     * @return $this
+     */
+    public function setTags(array<string> $tags): this {
+        $tags = array_values(array_unique($tags));
+        sort($tags);
+
+        $this->tags = $tags;
+
+        return $this;
+    }
+
 }
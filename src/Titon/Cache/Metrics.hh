@@ -0,0 +1,146 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache;
+
+/**
+ * Collects counters (hits, misses, sets, bytes read and written) and a latency histogram per operation
+ * for a storage engine, which can then be reported to a sink.
+ *
+ * @package Titon\Cache
+ */
+class Metrics {
+
+    /**
+     * Counters keyed by name.
+     *
+     * @var Map<string, int>
+     */
+    protected Map<string, int> $counters = Map {};
+
+    /**
+     * Latency histograms keyed by operation.
+     *
+     * @var Map<string, \Titon\Cache\Histogram>
+     */
+    protected Map<string, Histogram> $latencies = Map {};
+
+    /**
+     * Increase a counter by the defined step.
+     *
+     * @param string $name
+     * @param int $step
+     * @return $this
+     */
+    public function count(string $name, int $step = 1): this {
+        $this->counters[$name] = $this->getCounter($name) + $step;
+
+        return $this;
+    }
+
+    /**
+     * Return the value of a counter.
+     *
+     * @param string $name
+     * @return int
+     */
+    public function getCounter(string $name): int {
+        return $this->counters->get($name) ?: 0;
+    }
+
+    /**
+     * Return all counters.
+     *
+     * @return Map<string, int>
+     */
+    public function getCounters(): Map<string, int> {
+        return $this->counters;
+    }
+
+    /**
+     * Return the ratio of hits to lookups, between 0 and 1.
+     *
+     * @return float
+     */
+    public function getHitRatio(): float {
+        $hits = $this->getCounter(Storage::HITS);
+        $lookups = $hits + $this->getCounter(Storage::MISSES);
+
+        return $lookups ? ($hits / $lookups) : 0.0;
+    }
+
+    /**
+     * Return all latency histograms.
+     *
+     * @return Map<string, \Titon\Cache\Histogram>
+     */
+    public function getLatencies(): Map<string, Histogram> {
+        return $this->latencies;
+    }
+
+    /**
+     * Return the latency histogram for an operation, creating it if it does not exist.
+     *
+     * @param string $operation
+     * @return \Titon\Cache\Histogram
+     */
+    public function getLatency(string $operation): Histogram {
+        if (!$this->latencies->contains($operation)) {
+            $this->latencies[$operation] = new Histogram();
+        }
+
+        return $this->latencies[$operation];
+    }
+
+    /**
+     * Remove all counters and latencies.
+     *
+     * @return $this
+     */
+    public function reset(): this {
+        $this->counters->clear();
+        $this->latencies->clear();
+
+        return $this;
+    }
+
+    /**
+     * Record the duration of an operation in seconds.
+     *
+     * @param string $operation
+     * @param float $seconds
+     * @return $this
+     */
+    public function time(string $operation, float $seconds): this {
+        $this->getLatency($operation)->add($seconds);
+
+        return $this;
+    }
+
+    /**
+     * Return a snapshot of the counters, the hit ratio, and the latency of each operation in milliseconds,
+     * keyed as `latency.<operation>`.
+     *
+     * @return \Titon\Cache\StatsMap
+     */
+    public function toMap(): StatsMap {
+        $stats = Map {};
+
+        foreach ($this->getCounters() as $name => $value) {
+            $stats[$name] = $value;
+        }
+
+        $stats[Storage::HIT_RATIO] = round($this->getHitRatio(), 4);
+
+        foreach ($this->getLatencies() as $operation => $histogram) {
+            $stats['latency.' . $operation] = $histogram->toMap();
+        }
+
+        return $stats;
+    }
+
+}
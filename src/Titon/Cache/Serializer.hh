@@ -0,0 +1,33 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache;
+
+/**
+ * A Serializer converts values to and from strings before they are written to a storage engine.
+ *
+ * @package Titon\Cache
+ */
+interface Serializer {
+
+    /**
+     * Convert a value to a string.
+     *
+     * @param mixed $value
+     * @return string
+     */
+    public function serialize(mixed $value): string;
+
+    /**
+     * Convert a string back to the original value.
+     *
+     * @param string $data
+     * @return mixed
+     */
+    public function unserialize(string $data): mixed;
+
+}
@@ -0,0 +1,48 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Serializer;
+
+use Titon\Cache\Serializer;
+use RuntimeException;
+
+/**
+ * Serializes values using the HHVM compact serialization format, which is smaller and faster
+ * to decode than the native format, but does not support objects.
+ *
+ * @package Titon\Cache\Serializer
+ */
+class CompactSerializer implements Serializer {
+
+    /**
+     * Validate that compact serialization is available.
+     *
+     * @throws \RuntimeException
+     */
+    public function __construct() {
+        if (!function_exists('fb_compact_serialize')) {
+            throw new RuntimeException('Compact serialization requires HHVM');
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function serialize(mixed $value): string {
+        return (string) fb_compact_serialize($value);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unserialize(string $data): mixed {
+        $success = false;
+
+        return fb_compact_unserialize($data, $success);
+    }
+
+}
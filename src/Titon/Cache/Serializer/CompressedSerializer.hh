@@ -0,0 +1,135 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Serializer;
+
+use Titon\Cache\Exception\CorruptedItemException;
+use Titon\Cache\Serializer;
+
+/**
+ * Wraps another serializer and compresses the serialized data once it reaches a size threshold.
+ * LZ4 is used when the extension is available, as it decompresses much faster, otherwise zlib is used.
+ * A single byte header identifies the compression, so data written with either can always be read.
+ * Data that cannot be decompressed is rejected, instead of being passed to the wrapped serializer.
+ *
+ * {{{
+ *        new CompressedSerializer(new PhpSerializer(), 1024);
+ * }}}
+ *
+ * @package Titon\Cache\Serializer
+ */
+class CompressedSerializer implements Serializer {
+
+    const string LZ4 = 'l';
+    const string RAW = 'r';
+    const string ZLIB = 'z';
+
+    /**
+     * zlib compression level.
+     *
+     * @var int
+     */
+    protected int $level;
+
+    /**
+     * The wrapped serializer.
+     *
+     * @var \Titon\Cache\Serializer
+     */
+    protected Serializer $serializer;
+
+    /**
+     * Minimum size in bytes before data is compressed.
+     *
+     * @var int
+     */
+    protected int $threshold;
+
+    /**
+     * Set the wrapped serializer and compression settings.
+     *
+     * @param \Titon\Cache\Serializer $serializer
+     * @param int $threshold
+     * @param int $level
+     */
+    public function __construct(Serializer $serializer, int $threshold = 1024, int $level = 6) {
+        $this->serializer = $serializer;
+        $this->threshold = max(0, $threshold);
+        $this->level = min(9, max(1, $level));
+    }
+
+    /**
+     * Return the wrapped serializer.
+     *
+     * @return \Titon\Cache\Serializer
+     */
+    public function getSerializer(): Serializer {
+        return $this->serializer;
+    }
+
+    /**
+     * Return the minimum size in bytes before data is compressed.
+     *
+     * @return int
+     */
+    public function getThreshold(): int {
+        return $this->threshold;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function serialize(mixed $value): string {
+        $data = $this->getSerializer()->serialize($value);
+
+        if (strlen($data) < $this->threshold) {
+            return self::RAW . $data;
+        }
+
+        if (function_exists('lz4_compress')) {
+            $type = self::LZ4;
+            $compressed = lz4_compress($data);
+        } else {
+            $type = self::ZLIB;
+            $compressed = gzcompress($data, $this->level);
+        }
+
+        // Compression does not always make the data smaller
+        if (!is_string($compressed) || strlen($compressed) >= strlen($data)) {
+            return self::RAW . $data;
+        }
+
+        return $type . $compressed;
+    }
+
+    /**
+     * {@inheritdoc}
+     *
+     * @throws \Titon\Cache\Exception\CorruptedItemException
+     */
+    public function unserialize(string $data): mixed {
+        $type = substr($data, 0, 1);
+        $data = (string) substr($data, 1);
+
+        if ($type === self::LZ4) {
+            $data = function_exists('lz4_uncompress') ? @lz4_uncompress($data) : false;
+
+        } else if ($type === self::ZLIB) {
+            $data = @gzuncompress($data);
+
+        } else if ($type !== self::RAW) {
+            throw new CorruptedItemException(sprintf('Unknown compression header %s', $type));
+        }
+
+        if (!is_string($data)) {
+            throw new CorruptedItemException('Failed to decompress cached data');
+        }
+
+        return $this->getSerializer()->unserialize($data);
+    }
+
+}
@@ -0,0 +1,48 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Serializer;
+
+use Titon\Cache\Serializer;
+use RuntimeException;
+
+/**
+ * Serializes values using the igbinary binary format, which is compact for
+ * large arrays with repeated keys and strings; requires pecl/igbinary.
+ *
+ * @link http://pecl.php.net/package/igbinary
+ *
+ * @package Titon\Cache\Serializer
+ */
+class IgbinarySerializer implements Serializer {
+
+    /**
+     * Validate that igbinary is installed.
+     *
+     * @throws \RuntimeException
+     */
+    public function __construct() {
+        if (!extension_loaded('igbinary')) {
+            throw new RuntimeException('igbinary extension is not loaded');
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function serialize(mixed $value): string {
+        return igbinary_serialize($value);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unserialize(string $data): mixed {
+        return igbinary_unserialize($data);
+    }
+
+}
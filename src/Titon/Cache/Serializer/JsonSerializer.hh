@@ -0,0 +1,34 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Serializer;
+
+use Titon\Cache\Serializer;
+
+/**
+ * Serializes values as JSON. Objects and collections are unserialized as arrays,
+ * so this serializer is best suited for scalars and arrays that are shared with other languages.
+ *
+ * @package Titon\Cache\Serializer
+ */
+class JsonSerializer implements Serializer {
+
+    /**
+     * {@inheritdoc}
+     */
+    public function serialize(mixed $value): string {
+        return json_encode($value);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unserialize(string $data): mixed {
+        return json_decode($data, true);
+    }
+
+}
@@ -0,0 +1,34 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Serializer;
+
+use Titon\Cache\Serializer;
+
+/**
+ * Serializes values using the native `serialize()` and `unserialize()` functions.
+ * Supports all values, including objects.
+ *
+ * @package Titon\Cache\Serializer
+ */
+class PhpSerializer implements Serializer {
+
+    /**
+     * {@inheritdoc}
+     */
+    public function serialize(mixed $value): string {
+        return serialize($value);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unserialize(string $data): mixed {
+        return unserialize($data);
+    }
+
+}
@@ -0,0 +1,25 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache;
+
+/**
+ * A Sink receives the metrics collected by an instrumented storage engine, usually once per request.
+ *
+ * @package Titon\Cache
+ */
+interface Sink {
+
+    /**
+     * Report the metrics of a storage engine.
+     *
+     * @param string $name
+     * @param \Titon\Cache\Metrics $metrics
+     */
+    public function report(string $name, Metrics $metrics): void;
+
+}
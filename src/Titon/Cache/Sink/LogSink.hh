@@ -0,0 +1,80 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Sink;
+
+use Psr\Log\LoggerInterface;
+use Psr\Log\LogLevel;
+use Titon\Cache\Metrics;
+use Titon\Cache\Sink;
+
+/**
+ * Writes the metrics of a storage engine as a single line to a PSR-3 logger, for example:
+ * `cache.default hits=10 misses=2 hit.ratio=0.8333 getItem.p50=0.016ms getItem.p95=0.032ms ...`.
+ *
+ * @package Titon\Cache\Sink
+ */
+class LogSink implements Sink {
+
+    /**
+     * Log level to write with.
+     *
+     * @var string
+     */
+    protected string $level;
+
+    /**
+     * The PSR-3 logger.
+     *
+     * @var \Psr\Log\LoggerInterface
+     */
+    protected LoggerInterface $logger;
+
+    /**
+     * Set the logger and level.
+     *
+     * @param \Psr\Log\LoggerInterface $logger
+     * @param string $level
+     */
+    public function __construct(LoggerInterface $logger, string $level = LogLevel::INFO) {
+        $this->logger = $logger;
+        $this->level = $level;
+    }
+
+    /**
+     * Format the metrics into a line of `key=value` pairs.
+     *
+     * @param string $name
+     * @param \Titon\Cache\Metrics $metrics
+     * @return string
+     */
+    public function format(string $name, Metrics $metrics): string {
+        $pairs = ['cache.' . $name];
+
+        foreach ($metrics->getCounters() as $counter => $value) {
+            $pairs[] = $counter . '=' . $value;
+        }
+
+        $pairs[] = sprintf('hit.ratio=%.4f', $metrics->getHitRatio());
+
+        foreach ($metrics->getLatencies() as $operation => $histogram) {
+            foreach ($histogram->toMap() as $stat => $value) {
+                $pairs[] = sprintf(($stat === 'count') ? '%s.%s=%d' : '%s.%s=%.3fms', $operation, $stat, $value);
+            }
+        }
+
+        return implode(' ', $pairs);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function report(string $name, Metrics $metrics): void {
+        $this->logger->log($this->level, $this->format($name, $metrics));
+    }
+
+}
@@ -0,0 +1,54 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Sink;
+
+use Titon\Cache\Metrics;
+use Titon\Cache\Sink;
+use Titon\Cache\StatsMap;
+
+/**
+ * Keeps the latest snapshot of metrics for each storage engine in memory, for debugging and testing.
+ *
+ * @package Titon\Cache\Sink
+ */
+class MemorySink implements Sink {
+
+    /**
+     * Latest snapshot keyed by storage name.
+     *
+     * @var Map<string, \Titon\Cache\StatsMap>
+     */
+    protected Map<string, StatsMap> $reports = Map {};
+
+    /**
+     * Return the latest snapshot for a storage engine.
+     *
+     * @param string $name
+     * @return \Titon\Cache\StatsMap
+     */
+    public function getReport(string $name): ?StatsMap {
+        return $this->reports->get($name);
+    }
+
+    /**
+     * Return the latest snapshot of every storage engine.
+     *
+     * @return Map<string, \Titon\Cache\StatsMap>
+     */
+    public function getReports(): Map<string, StatsMap> {
+        return $this->reports;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function report(string $name, Metrics $metrics): void {
+        $this->reports[$name] = $metrics->toMap();
+    }
+
+}
@@ -0,0 +1,149 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Sink;
+
+use Titon\Cache\Metrics;
+use Titon\Cache\Sink;
+
+/**
+ * Sends metrics to a statsd daemon over UDP, which never blocks the request waiting for a response.
+ * Counters are sent as statsd counters, and the latency percentiles of each operation as gauges in milliseconds,
+ * since the histograms have already been aggregated in-process.
+ *
+ * {{{
+ *        new StatsdSink('127.0.0.1', 8125, 'app.cache');
+ * }}}
+ *
+ * @package Titon\Cache\Sink
+ */
+class StatsdSink implements Sink {
+
+    /**
+     * Maximum size of a packet, which avoids fragmentation on most networks.
+     */
+    const int PACKET_SIZE = 512;
+
+    /**
+     * Host of the statsd daemon.
+     *
+     * @var string
+     */
+    protected string $host;
+
+    /**
+     * Port of the statsd daemon.
+     *
+     * @var int
+     */
+    protected int $port;
+
+    /**
+     * Prefix prepended to every metric name.
+     *
+     * @var string
+     */
+    protected string $prefix;
+
+    /**
+     * The UDP socket, which is opened on first use.
+     *
+     * @var resource
+     */
+    protected ?resource $socket;
+
+    /**
+     * Set the address of the statsd daemon and the metric prefix.
+     *
+     * @param string $host
+     * @param int $port
+     * @param string $prefix
+     */
+    public function __construct(string $host = '127.0.0.1', int $port = 8125, string $prefix = 'cache') {
+        $this->host = $host;
+        $this->port = $port;
+        $this->prefix = $prefix;
+    }
+
+    /**
+     * Close the socket.
+     */
+    public function __destruct() {
+        if ($this->socket) {
+            fclose($this->socket);
+        }
+    }
+
+    /**
+     * Format the metrics into statsd lines.
+     *
+     * @param string $name
+     * @param \Titon\Cache\Metrics $metrics
+     * @return array<string>
+     */
+    public function format(string $name, Metrics $metrics): array<string> {
+        $prefix = trim($this->prefix . '.' . $name, '.') . '.';
+        $lines = [];
+
+        foreach ($metrics->getCounters() as $counter => $value) {
+            $lines[] = sprintf('%s%s:%d|c', $prefix, $counter, $value);
+        }
+
+        $lines[] = sprintf('%shit.ratio:%.4f|g', $prefix, $metrics->getHitRatio());
+
+        foreach ($metrics->getLatencies() as $operation => $histogram) {
+            foreach ($histogram->toMap() as $stat => $value) {
+                $lines[] = ($stat === 'count')
+                    ? sprintf('%slatency.%s.count:%d|c', $prefix, $operation, $value)
+                    : sprintf('%slatency.%s.%s:%.3f|g', $prefix, $operation, $stat, $value);
+            }
+        }
+
+        return $lines;
+    }
+
+    /**
+     * Send the lines in as few packets as possible. Failures are ignored, as metrics are not critical.
+     *
+     * {@inheritdoc}
+     */
+    public function report(string $name, Metrics $metrics): void {
+        $packet = '';
+
+        foreach ($this->format($name, $metrics) as $line) {
+            if ($packet !== '' && strlen($packet) + strlen($line) + 1 > self::PACKET_SIZE) {
+                $this->send($packet);
+                $packet = '';
+            }
+
+            $packet .= ($packet === '') ? $line : "\n" . $line;
+        }
+
+        if ($packet !== '') {
+            $this->send($packet);
+        }
+    }
+
+    /**
+     * Write a packet to the UDP socket, opening the socket if necessary.
+     *
+     * @param string $packet
+     */
+    protected function send(string $packet): void {
+        if (!$this->socket) {
+            $errno = 0;
+            $errstr = '';
+
+            $this->socket = @stream_socket_client(sprintf('udp://%s:%s', $this->host, $this->port), $errno, $errstr) ?: null;
+        }
+
+        if ($this->socket) {
+            @fwrite($this->socket, $packet);
+        }
+    }
+
+}
@@ -7,6 +7,8 @@
 
 namespace Titon\Cache;
 
+use Titon\Utility\OptionMap;
+
 /**
  * Interface for the storage containers library.
  *
@@ -16,9 +18,15 @@ interface Storage {
 
     const string HITS = 'hits';
     const string MISSES = 'misses';
+    const string EVICTIONS = 'evictions';
+    const string ITEMS = 'items';
     const string UPTIME = 'uptime';
     const string MEMORY_USAGE = 'memory.usage';
     const string MEMORY_AVAILABLE = 'memory.available';
+    const string SETS = 'sets';
+    const string BYTES_READ = 'bytes.read';
+    const string BYTES_WRITTEN = 'bytes.written';
+    const string HIT_RATIO = 'hit.ratio';
 
     /**
      * Deletes all items in the pool.
@@ -38,7 +46,9 @@ interface Storage {
 
     /**
      * Decrement a value within the cache and return the new number.
-     * If the item does not exist, it will create the item with an initial value.
+     * If the item does not exist, it will create the item with an initial value,
+     * which expires after the default cache duration.
+     * Storage engines should perform the update atomically, and keep the expiration of existing items.
      *
      * @param string $key
      * @param int $step
@@ -71,6 +81,39 @@ interface Storage {
      */
     public function flush(): bool;
 
+    /**
+     * Asynchronous version of `get()`, which allows multiple lookups and other I/O to be awaited in parallel.
+     *
+     * @param string $key
+     * @return Awaitable<mixed>
+     * @throws \Titon\Cache\Exception\MissingItemException
+     */
+    public function genGet(string $key): Awaitable<mixed>;
+
+    /**
+     * Asynchronous version of `getItem()`.
+     *
+     * @param string $key
+     * @return Awaitable<\Titon\Cache\Item>
+     */
+    public function genGetItem(string $key): Awaitable<Item>;
+
+    /**
+     * Asynchronous version of `getItems()`.
+     *
+     * @param array<string> $keys
+     * @return Awaitable<\Titon\Cache\ItemMap>
+     */
+    public function genGetItems(array<string> $keys = []): Awaitable<ItemMap>;
+
+    /**
+     * Asynchronous version of `save()`.
+     *
+     * @param \Titon\Cache\Item $item
+     * @return Awaitable<$this>
+     */
+    public function genSave(Item $item): Awaitable<this>;
+
     /**
      * Return the raw value from the storage pool instead of returning an item.
      * If the item does not exist, throw a MissingItemException.
@@ -87,6 +130,9 @@ interface Storage {
      * This method must always return an ItemInterface object, even in case of
      * a cache miss. It MUST NOT return null.
      *
+     * This is the primary read operation of a storage engine, and must determine a hit or a miss
+     * and fetch the value with a single lookup.
+     *
      * @param string $key
      *   The key for which to return the corresponding Cache Item.
      * @return \Titon\Cache\Item
@@ -106,6 +152,15 @@ interface Storage {
      */
     public function getItems(array<string> $keys = []): ItemMap;
 
+    /**
+     * Return the raw values for multiple keys from the storage pool in as few round trips as possible.
+     * Keys that do not exist are not included in the returned map.
+     *
+     * @param array<string> $keys
+     * @return \Titon\Cache\ValueMap
+     */
+    public function getMany(array<string> $keys): ValueMap;
+
     /**
      * Return the unique cache key prefix.
      *
@@ -123,7 +178,9 @@ interface Storage {
 
     /**
      * Increment a value within the cache and return the new number.
-     * If the item does not exist, it will create the item with an initial value.
+     * If the item does not exist, it will create the item with an initial value,
+     * which expires after the default cache duration.
+     * Storage engines should perform the update atomically, and keep the expiration of existing items.
      *
      * @param string $key
      * @param int $step
@@ -132,6 +189,25 @@ interface Storage {
      */
     public function increment(string $key, int $step = 1, int $initial = 0): int;
 
+    /**
+     * Invalidate all items that were saved with any of the defined tags, by changing the version of each tag.
+     * This is a constant time operation, regardless of how many items use the tags.
+     *
+     * @param array<string> $tags
+     * @return bool
+     */
+    public function invalidateTags(array<string> $tags): bool;
+
+    /**
+     * Attempt to acquire an exclusive lock for a key, which expires after the defined seconds.
+     * Return false if the lock is held by another process.
+     *
+     * @param string $key
+     * @param int $ttl
+     * @return bool
+     */
+    public function lock(string $key, int $ttl): bool;
+
     /**
      * Remove the item if it exists and return true, else return false.
      *
@@ -140,6 +216,14 @@ interface Storage {
      */
     public function remove(string $key): bool;
 
+    /**
+     * Remove multiple items in as few round trips as possible.
+     *
+     * @param array<string> $keys
+     * @return bool
+     */
+    public function removeMany(array<string> $keys): bool;
+
     /**
      * Persists a cache item immediately.
      *
@@ -159,6 +243,14 @@ interface Storage {
      */
     public function saveDeferred(Item $item): this;
 
+    /**
+     * Persists multiple cache items immediately, in as few round trips as possible.
+     *
+     * @param \Titon\Cache\ItemList $items
+     * @return $this
+     */
+    public function saveMany(ItemList $items): this;
+
     /**
      * Write data to the storage cache directly.
      *
@@ -169,6 +261,15 @@ interface Storage {
      */
     public function set(string $key, mixed $value, int $expires): bool;
 
+    /**
+     * Write multiple values that share the same expiration to the storage cache directly.
+     *
+     * @param \Titon\Cache\ValueMap $values
+     * @param int $expires
+     * @return bool
+     */
+    public function setMany(ValueMap $values, int $expires): bool;
+
     /**
      * Set the unique cache key prefix.
      *
@@ -191,8 +292,30 @@ interface Storage {
      * @param string $key
      * @param \Titon\Cache\CacheCallback $callback
      * @param mixed $expires
+     * @param \Titon\Utility\OptionMap $options {
+     *      @var int $lock      Seconds to hold a lock while recomputing, so that only one process runs the callback
+     *      @var int $wait      Milliseconds to wait for another process to recompute before running the callback
+     *      @var float $beta    Probabilistic early expiration factor, where higher values recompute earlier
+     *      @var int $stale     Seconds to serve an expired value while another process recomputes
+     * }
      * @return mixed
      */
-    public function store(string $key, CacheCallback $callback, mixed $expires = null): mixed;
+    public function store(string $key, CacheCallback $callback, mixed $expires = null, OptionMap $options = Map {}): mixed;
+
+    /**
+     * Return a view of the storage where all keys are namespaced by the current version of the defined tags.
+     *
+     * @param array<string> $tags
+     * @return \Titon\Cache\Storage
+     */
+    public function tagged(array<string> $tags): Storage;
+
+    /**
+     * Release a lock that was acquired with `lock()`.
+     *
+     * @param string $key
+     * @return bool
+     */
+    public function unlock(string $key): bool;
 
 }
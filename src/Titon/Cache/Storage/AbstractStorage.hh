@@ -14,9 +14,14 @@ use Titon\Cache\Item;
 use Titon\Cache\ItemList;
 use Titon\Cache\ItemMap;
 use Titon\Cache\MissItem;
+use Titon\Cache\Serializer;
+use Titon\Cache\Serializer\PhpSerializer;
 use Titon\Cache\StatsMap;
 use Titon\Cache\Storage;
+use Titon\Cache\StoreMeta;
+use Titon\Cache\ValueMap;
 use Titon\Utility\Config;
+use Titon\Utility\OptionMap;
 
 /**
  * Primary class for all storage engines to extend. Provides functionality for the Storage interface.
@@ -25,6 +30,19 @@ use Titon\Utility\Config;
  */
 abstract class AbstractStorage implements Storage {
 
+    /**
+     * Number of seconds to keep tag versions. If a version is evicted, a new version is created,
+     * which only causes the tagged items to be invalidated.
+     */
+    const int TAG_TTL = 2592000;
+
+    /**
+     * Should deferred items be committed automatically once the request has finished.
+     *
+     * @var bool
+     */
+    protected bool $autoCommit = false;
+
     /**
      * List of cache items to be committed.
      *
@@ -39,6 +57,47 @@ abstract class AbstractStorage implements Storage {
      */
     protected string $prefix = '';
 
+    /**
+     * The global and storage prefix combined, and the configuration revision it was resolved at.
+     *
+     * @var string
+     */
+    protected string $resolvedPrefix = '';
+
+    /**
+     * @var int
+     */
+    protected int $resolvedRevision = -1;
+
+    /**
+     * Has the auto commit callback been registered.
+     *
+     * @var bool
+     */
+    protected bool $registered = false;
+
+    /**
+     * Timestamp of when the tag versions were loaded. Versions are re-read every second
+     * so that long running processes pick up invalidations from other processes.
+     *
+     * @var int
+     */
+    protected int $tagTime = 0;
+
+    /**
+     * Current version of each tag that has been loaded.
+     *
+     * @var Map<string, string>
+     */
+    protected Map<string, string> $tagVersions = Map {};
+
+    /**
+     * Serializer used by storage engines that store strings.
+     *
+     * @var \Titon\Cache\Serializer
+     */
+    protected ?Serializer $serializer;
+
     /**
      * Set the unique prefix during instantiation.
      *
@@ -59,11 +118,15 @@ abstract class AbstractStorage implements Storage {
      * {@inheritdoc}
      */
     public function commit(): bool {
-        foreach ($this->getDeferred() as $item) {
-            $this->save($item);
+        $deferred = $this->getDeferred();
+
+        if ($deferred->isEmpty()) {
+            return true;
         }
 
-        $this->getDeferred()->clear();
+        $this->saveMany($deferred->toVector());
+
+        $deferred->clear();
 
         return true;
     }
@@ -72,15 +135,7 @@ abstract class AbstractStorage implements Storage {
      * {@inheritdoc}
      */
     public function decrement(string $key, int $step = 1, int $initial = 0): int {
-        $item = $this->getItem($key);
-
-        $value = ((int) $item->get() ?: $initial) - $step;
-
-        $item->set($value);
-
-        $this->save($item);
-
-        return $value;
+        return $this->increment($key, -$step, $initial);
     }
 
     /**
@@ -96,13 +151,78 @@ abstract class AbstractStorage implements Storage {
      * {@inheritdoc}
      */
     public function deleteItems(array<string> $keys): this {
-        foreach ($keys as $key) {
-            $this->remove($key);
+        $this->removeMany($keys);
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genGet(string $key): Awaitable<mixed> {
+        $item = await $this->genGetItem($key);
+
+        if (!$item->isHit()) {
+            throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
         }
 
+        return $item->get();
+    }
+
+    /**
+     * The default implementation is blocking. Storage engines with a non-blocking client should override this method.
+     *
+     * {@inheritdoc}
+     */
+    public async function genGetItem(string $key): Awaitable<Item> {
+        return $this->getItem($key);
+    }
+
+    /**
+     * The default implementation is blocking, but fetches all items in a single batch.
+     *
+     * {@inheritdoc}
+     */
+    public async function genGetItems(array<string> $keys = []): Awaitable<ItemMap> {
+        return $this->getItems($keys);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genSave(Item $item): Awaitable<this> {
+        $tags = $this->getExtraTags($item);
+
+        if ($tags) {
+            await $this->tagged($tags)->genSave($item);
+
+            return $this;
+        }
+
+        $timestamp = $item->getExpiration()?->getTimestamp() ?: 0;
+
+        if ($timestamp <= time()) {
+            return $this; // Already expired
+        }
+
+        await $this->genSet($item->getKey(), $item->get(), $timestamp);
+
         return $this;
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function get(string $key): mixed {
+        $item = $this->getItem($key);
+
+        if (!$item->isHit()) {
+            throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
+        }
+
+        return $item->get();
+    }
+
     /**
      * Return a list of items waiting to be cached.
      *
@@ -115,35 +235,124 @@ abstract class AbstractStorage implements Storage {
     /**
      * {@inheritdoc}
      */
-    public function getItem(string $key): Item {
-        try {
-            return new HitItem($key, $this->get($key));
-        } catch (MissingItemException $e) {
-            return new MissItem($key);
+    public function getItems(array<string> $keys = []): ItemMap {
+        $values = $this->getMany($keys);
+        $map = Map {};
+
+        foreach ($keys as $key) {
+            $map[$key] = $values->contains($key) ? new HitItem($key, $values[$key]) : new MissItem($key);
         }
+
+        return $map;
     }
 
     /**
      * {@inheritdoc}
      */
-    public function getItems(array<string> $keys = []): ItemMap {
-        $map = Map {};
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
 
         foreach ($keys as $key) {
-            $map[$key] = $this->getItem($key);
+            $item = $this->getItem($key);
+
+            if ($item->isHit()) {
+                $values[$key] = $item->get();
+            }
         }
 
-        return $map;
+        return $values;
     }
 
     /**
      * {@inheritdoc}
      */
     public function getPrefix(): string {
-        return (string) Config::get('cache.prefix', '') . $this->prefix;
+        $revision = Config::revision();
+
+        if ($this->resolvedRevision !== $revision) {
+            $this->resolvedPrefix = (string) Config::get('cache.prefix', '') . $this->prefix;
+            $this->resolvedRevision = $revision;
+        }
+
+        return $this->resolvedPrefix;
     }
 
     /**
+     * Return the serializer, which defaults to native serialization.
+     *
+     * @return \Titon\Cache\Serializer
+     */
+    public function getSerializer(): Serializer {
+        if ($this->serializer === null) {
+            $this->serializer = new PhpSerializer();
+        }
+
+        return $this->serializer;
+    }
+
+    /**
+     * Return the tags that the keys of this storage are namespaced by.
+     *
+     * @return array<string>
+     */
+    public function getTags(): array<string> {
+        return [];
+    }
+
+    /**
+     * Return the current version of each tag. Tags without a version are assigned one.
+     *
+     * @param array<string> $tags
+     * @return Map<string, string>
+     */
+    public function getTagVersions(array<string> $tags): Map<string, string> {
+        $time = time();
+
+        if ($this->tagTime !== $time) {
+            $this->tagVersions->clear();
+            $this->tagTime = $time;
+        }
+
+        $missing = [];
+
+        foreach ($tags as $tag) {
+            if (!$this->tagVersions->contains($tag)) {
+                $missing[] = $tag;
+            }
+        }
+
+        if ($missing) {
+            $found = $this->getMany(array_map($tag ==> 'tag.' . $tag, $missing));
+            $created = Map {};
+
+            foreach ($missing as $tag) {
+                $version = $found->get('tag.' . $tag);
+
+                if ($version === null) {
+                    $version = $created['tag.' . $tag] = $this->generateTagVersion();
+                }
+
+                $this->tagVersions[$tag] = (string) $version;
+            }
+
+            if ($created) {
+                $this->setMany($created, time() + self::TAG_TTL);
+            }
+        }
+
+        $versions = Map {};
+
+        foreach ($tags as $tag) {
+            $versions[$tag] = $this->tagVersions[$tag];
+        }
+
+        return $versions;
+    }
+
+    /**
+     * The default implementation is not atomic, and resets the expiration of the item.
+     * Storage engines should override this method when the backend supports atomic updates.
+     *
      * {@inheritdoc}
      */
     public function increment(string $key, int $step = 1, int $initial = 0): int {
@@ -151,17 +360,74 @@ abstract class AbstractStorage implements Storage {
 
         $value = ((int) $item->get() ?: $initial) + $step;
 
-        $item->set($value);
-
-        $this->save($item);
+        $this->set($key, $value, $this->getDefaultExpiration());
 
         return $value;
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function invalidateTags(array<string> $tags): bool {
+        $versions = Map {};
+
+        foreach ($tags as $tag) {
+            $versions['tag.' . $tag] = $this->tagVersions[$tag] = $this->generateTagVersion();
+        }
+
+        return $this->setMany($versions, time() + self::TAG_TTL);
+    }
+
+    /**
+     * Return true if deferred items will be committed automatically.
+     *
+     * @return bool
+     */
+    public function isAutoCommit(): bool {
+        return $this->autoCommit;
+    }
+
+    /**
+     * Emulate a lock using a separate cache key. Storage engines should override this method
+     * with an atomic operation when the backend supports one.
+     *
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        $lockKey = $key . '.lock';
+
+        if ($this->has($lockKey)) {
+            return false;
+        }
+
+        return $this->set($lockKey, 1, time() + $ttl);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        $removed = true;
+
+        foreach ($keys as $key) {
+            $removed = $this->remove($key) && $removed;
+        }
+
+        return $removed;
+    }
+
     /**
      * {@inheritdoc}
      */
     public function save(Item $item): this {
+        $tags = $this->getExtraTags($item);
+
+        if ($tags) {
+            $this->tagged($tags)->save($item);
+
+            return $this;
+        }
+
         $timestamp = $item->getExpiration()?->getTimestamp() ?: 0;
 
         if ($timestamp <= time()) {
@@ -182,11 +448,127 @@ abstract class AbstractStorage implements Storage {
         return $this;
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function saveMany(ItemList $items): this {
+        $time = time();
+        $latest = Map {};
+        $batches = Map {};
+        $tagged = Map {};
+
+        // Coalesce multiple writes to the same key, the last one wins
+        foreach ($items as $item) {
+            $latest[$item->getKey()] = $item;
+        }
+
+        // Tagged items are saved through the tagged view, grouped by tags
+        foreach ($latest->toMap() as $key => $item) {
+            $tags = $this->getExtraTags($item);
+
+            if (!$tags) {
+                continue;
+            }
+
+            $group = implode(',', $tags);
+
+            if (!$tagged->contains($group)) {
+                $tagged[$group] = Vector {};
+            }
+
+            $list = $tagged[$group];
+            $list[] = $item;
+            $latest->remove($key);
+        }
+
+        foreach ($tagged as $group => $list) {
+            $this->tagged(explode(',', $group))->saveMany($list);
+        }
+
+        // Group the items by expiration so that each group can be written at once
+        foreach ($latest as $item) {
+            $timestamp = $item->getExpiration()?->getTimestamp() ?: 0;
+
+            if ($timestamp <= $time) {
+                continue; // Already expired
+            }
+
+            if (!$batches->contains($timestamp)) {
+                $batches[$timestamp] = Map {};
+            }
+
+            $batch = $batches[$timestamp];
+            $batch[$item->getKey()] = $item->get();
+        }
+
+        foreach ($batches as $timestamp => $values) {
+            $this->setMany($values, $timestamp);
+        }
+
+        return $this;
+    }
+
+    /**
+     * Enable or disable automatic committing of deferred items once the request has finished.
+     * When available, the commit happens after the response has been sent to the client,
+     * which moves the cache writes off the critical path.
+     *
+     * @param bool $autoCommit
+     * @return $this
+     */
+    public function setAutoCommit(bool $autoCommit = true): this {
+        $this->autoCommit = $autoCommit;
+
+        if ($autoCommit && !$this->registered) {
+            $callback = () ==> {
+                if ($this->isAutoCommit()) {
+                    $this->commit();
+                }
+            };
+
+            if (function_exists('register_postsend_function')) {
+                register_postsend_function($callback);
+            } else {
+                register_shutdown_function($callback);
+            }
+
+            $this->registered = true;
+        }
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $saved = true;
+
+        foreach ($values as $key => $value) {
+            $saved = $this->set($key, $value, $expires) && $saved;
+        }
+
+        return $saved;
+    }
+
     /**
      * {@inheritdoc}
      */
     public function setPrefix(string $prefix): this {
         $this->prefix = $prefix;
+        $this->resolvedRevision = -1;
+
+        return $this;
+    }
+
+    /**
+     * Set the serializer used for converting values to strings.
+     *
+     * @param \Titon\Cache\Serializer $serializer
+     * @return $this
+     */
+    public function setSerializer(Serializer $serializer): this {
+        $this->serializer = $serializer;
 
         return $this;
     }
@@ -201,16 +583,247 @@ abstract class AbstractStorage implements Storage {
     /**
      * {@inheritdoc}
      */
-    public function store(string $key, CacheCallback $callback, mixed $expires = null): mixed {
-        if ($this->has($key)) {
-            return $this->getItem($key)->get();
+    public function store(string $key, CacheCallback $callback, mixed $expires = null, OptionMap $options = Map {}): mixed {
+        $options = (Map {
+            'lock' => 0,
+            'wait' => 100,
+            'beta' => 0.0,
+            'stale' => 0
+        })->setAll($options);
+
+        $lock = (int) $options['lock'];
+        $beta = (float) $options['beta'];
+        $stale = (int) $options['stale'];
+
+        // Without protection, a simple read through is enough
+        if (!$lock && !$beta && !$stale) {
+            $item = $this->getItem($key);
+
+            if ($item->isHit()) {
+                return $item->get();
+            }
+
+            $value = call_user_func($callback);
+
+            $this->save(new Item($key, $value, $expires));
+
+            return $value;
+        }
+
+        // Fetch the value and its metadata in a single round trip
+        $metaKey = $key . '.meta';
+        $values = $this->getMany([$key, $metaKey]);
+
+        if ($values->contains($key)) {
+            $meta = $values->get($metaKey);
+
+            if (!is_array($meta) || !$this->shouldRecompute(shape('delta' => (float) $meta['delta'], 'expires' => (int) $meta['expires']), $beta)) {
+                return $values[$key];
+            }
+
+            // Another process is recomputing, so serve the current value
+            if ($lock && !$this->lock($key, $lock)) {
+                return $values[$key];
+            }
+
+            return $this->recompute($key, $callback, $expires, $stale, (bool) $lock);
+        }
+
+        // Wait for another process to recompute the value instead of running the callback
+        if ($lock && !$this->lock($key, $lock)) {
+            $item = $this->waitFor($key, (int) $options['wait']);
+
+            if ($item->isHit()) {
+                return $item->get();
+            }
+
+            $lock = 0;
+        }
+
+        return $this->recompute($key, $callback, $expires, $stale, (bool) $lock);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function tagged(array<string> $tags): Storage {
+        return new TaggedStorage($this, $tags);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unlock(string $key): bool {
+        return $this->remove($key . '.lock');
+    }
+
+    /**
+     * Unserialize a value with the serializer, or convert it to an integer if it was stored as a raw counter.
+     *
+     * @param string $value
+     * @return mixed
+     */
+    protected function decode(string $value): mixed {
+        if (preg_match('/^-?[0-9]+$/', $value)) {
+            return (int) $value;
         }
 
-        $value = call_user_func($callback);
+        return $this->getSerializer()->unserialize($value);
+    }
+
+    /**
+     * Serialize a value with the serializer. Integers are stored as is,
+     * so that backends that store strings can update counters atomically.
+     *
+     * @param mixed $value
+     * @return string
+     */
+    protected function encode(mixed $value): string {
+        if (is_int($value)) {
+            return (string) $value;
+        }
+
+        return $this->getSerializer()->serialize($value);
+    }
+
+    /**
+     * Asynchronous version of `set()`. The default implementation is blocking.
+     *
+     * @param string $key
+     * @param mixed $value
+     * @param int $expires
+     * @return Awaitable<bool>
+     */
+    protected async function genSet(string $key, mixed $value, int $expires): Awaitable<bool> {
+        return $this->set($key, $value, $expires);
+    }
+
+    /**
+     * Generate a unique tag version.
+     *
+     * @return string
+     */
+    protected function generateTagVersion(): string {
+        return uniqid(dechex(mt_rand()), true);
+    }
+
+    /**
+     * Return the expiration timestamp for items created without an explicit expiration.
+     *
+     * @return int
+     */
+    protected function getDefaultExpiration(): int {
+        return strtotime((string) Config::get('cache.expires', '+1 hour'));
+    }
+
+    /**
+     * Return the tags of an item that this storage is not already namespaced by.
+     *
+     * @param \Titon\Cache\Item $item
+     * @return array<string>
+     */
+    protected function getExtraTags(Item $item): array<string> {
+        $tags = $item->getTags();
+
+        if (!$tags) {
+            return $tags;
+        }
 
-        $this->save(new Item($key, $value, $expires));
+        return array_values(array_diff($tags, $this->getTags()));
+    }
+
+    /**
+     * Map the prefixed version of each key to the original key, resolving the prefix once for the whole batch.
+     *
+     * @param array<string> $keys
+     * @return Map<string, string>
+     */
+    protected function prefixKeys(array<string> $keys): Map<string, string> {
+        $prefix = $this->getPrefix();
+        $map = Map {};
+
+        foreach ($keys as $key) {
+            $map[$prefix . $key] = $key;
+        }
+
+        return $map;
+    }
+
+    /**
+     * Run the callback and save the value along with the metadata required for early expiration.
+     * The value is kept for an additional stale period past its expiration. Release the lock once complete.
+     *
+     * @param string $key
+     * @param \Titon\Cache\CacheCallback $callback
+     * @param mixed $expires
+     * @param int $stale
+     * @param bool $locked
+     * @return mixed
+     */
+    protected function recompute(string $key, CacheCallback $callback, mixed $expires, int $stale, bool $locked): mixed {
+        try {
+            $start = microtime(true);
+            $value = call_user_func($callback);
+            $delta = microtime(true) - $start;
+
+            $timestamp = (new Item($key, $value, $expires))->getExpiration()?->getTimestamp() ?: 0;
+
+            if ($timestamp > time()) {
+                $meta = shape('delta' => $delta, 'expires' => $timestamp);
+
+                $this->setMany(Map {$key => $value, $key . '.meta' => $meta}, $timestamp + $stale);
+            }
+        } finally {
+            if ($locked) {
+                $this->unlock($key);
+            }
+        }
 
         return $value;
     }
 
+    /**
+     * Determine whether a value should be recomputed, either because it is stale,
+     * or because it was chosen for early expiration using the XFetch algorithm,
+     * which becomes more likely as the expiration approaches and the longer the value takes to compute.
+     *
+     * @param \Titon\Cache\StoreMeta $meta
+     * @param float $beta
+     * @return bool
+     */
+    protected function shouldRecompute(StoreMeta $meta, float $beta): bool {
+        $now = microtime(true);
+
+        if ($now >= $meta['expires']) {
+            return true;
+        }
+
+        if ($beta <= 0) {
+            return false;
+        }
+
+        $random = mt_rand(1, mt_getrandmax()) / mt_getrandmax();
+
+        return ($now - ($meta['delta'] * $beta * log($random)) >= $meta['expires']);
+    }
+
+    /**
+     * Poll for a value that is being recomputed by another process, for up to the defined milliseconds.
+     *
+     * @param string $key
+     * @param int $wait
+     * @return \Titon\Cache\Item
+     */
+    protected function waitFor(string $key, int $wait): Item {
+        $until = microtime(true) + ($wait / 1000);
+
+        do {
+            usleep(10000);
+
+            $item = $this->getItem($key);
+        } while (!$item->isHit() && microtime(true) < $until);
+
+        return $item;
+    }
+
 }
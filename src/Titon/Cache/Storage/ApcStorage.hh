@@ -7,8 +7,11 @@
 
 namespace Titon\Cache\Storage;
 
-use Titon\Cache\Exception\MissingItemException;
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
 use Titon\Cache\StatsMap;
+use Titon\Cache\ValueMap;
 use RuntimeException;
 
 /**
@@ -45,15 +48,37 @@ class ApcStorage extends AbstractStorage {
     /**
      * {@inheritdoc}
      */
-    public function get(string $key): mixed {
-        $success = true;
+    public function getItem(string $key): Item {
+        $success = false;
         $value = apc_fetch($this->getPrefix() . $key, $success);
 
-        if ($value === false && $success === false) {
-            throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
+        return $success ? new HitItem($key, $value) : new MissItem($key);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
+
+        if (!$keys) {
+            return $values;
+        }
+
+        $prefixed = $this->prefixKeys($keys);
+        $fetched = apc_fetch($prefixed->keys()->toArray());
+
+        if (!is_array($fetched)) {
+            return $values;
+        }
+
+        foreach ($prefixed as $prefixedKey => $key) {
+            if (array_key_exists($prefixedKey, $fetched)) {
+                $values[$key] = $fetched[$prefixedKey];
+            }
         }
 
-        return $value;
+        return $values;
     }
 
     /**
@@ -63,6 +88,26 @@ class ApcStorage extends AbstractStorage {
         return apc_exists($this->getPrefix() . $key);
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $key = $this->getPrefix() . $key;
+
+        apc_add($key, $initial, $this->getDefaultExpiration() - time());
+
+        $value = ($step < 0) ? apc_dec($key, -$step) : apc_inc($key, $step);
+
+        return (int) $value;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        return apc_add($this->getPrefix() . $key . '.lock', 1, $ttl);
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -70,6 +115,17 @@ class ApcStorage extends AbstractStorage {
         return apc_delete($this->getPrefix() . $key);
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        if (!$keys) {
+            return true;
+        }
+
+        return !apc_delete($this->prefixKeys($keys)->keys()->toArray()); // Returns the keys that failed
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -77,6 +133,25 @@ class ApcStorage extends AbstractStorage {
         return apc_store($this->getPrefix() . $key, $value, $expires - time()); // APC uses TTL
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $data = [];
+
+        $prefix = $this->getPrefix();
+
+        foreach ($values as $key => $value) {
+            $data[$prefix . $key] = $value;
+        }
+
+        if (!$data) {
+            return true;
+        }
+
+        return !apc_store($data, null, $expires - time()); // Returns the keys that failed
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -7,13 +7,13 @@
 
 namespace Titon\Cache\Storage;
 
-use Titon\Cache\Exception\MissingItemException;
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
 use Titon\Io\Exception\InvalidPathException;
-use Titon\Io\File;
 use Titon\Io\Folder;
 
 newtype FileCache = shape('expires' => int, 'data' => string);
-newtype FileMap = Map<string, File>;
 
 /**
  * A storage engine that uses the servers local filesystem to store its cached items.
@@ -23,17 +23,42 @@ newtype FileMap = Map<string, File>;
  *        new FileSystemStorage('/path/to/cache/');
  * }}}
  *
+ * Each item is stored in a file named after the hash of its key, within 2 levels of sharded folders
+ * to keep folder sizes small, for example `<path>/<generation>/a1/b2/a1b2c3....cache`.
+ * Files start with an expiration header line, so that expiration can be checked without reading the payload,
+ * and are written to a temporary file and renamed, so that readers never see a partial write.
+ *
+ * Flushing increments the generation, which moves all items to a new empty folder instead of deleting files.
+ * Previous generations and expired files can be removed at a later time with `purge()`.
+ *
+ * Lock files are stored outside of the generations, in `<path>/locks/`, so that held locks survive a flush,
+ * and are removed by `purge()` once they are no longer held. Locks acquired with `lock()` use `.lock` files,
+ * while counters and expired items are updated while holding a separate `.mutex` file, so that a process
+ * holding the lock of a key can still increment it.
+ *
  * @package Titon\Cache\Storage
  */
 class FileSystemStorage extends AbstractStorage {
 
     /**
-     * List of cached file objects for the current request.
-     * Does not include files that already exist.
-     *
-     * @var \Titon\Cache\FileMap
+     * Name of the file that stores the current generation.
+     */
+    const string GENERATION_FILE = 'generation';
+
+    /**
+     * Extension of lock files acquired with `lock()`.
+     */
+    const string LOCK_EXT = 'lock';
+
+    /**
+     * Name of the folder that stores lock files.
      */
-    protected FileMap $files = Map {};
+    const string LOCK_FOLDER = 'locks';
+
+    /**
+     * Extension of lock files held while a cache file is being updated or removed.
+     */
+    const string MUTEX_EXT = 'mutex';
 
     /**
      * Folder object for the cache folder.
@@ -42,6 +67,28 @@ class FileSystemStorage extends AbstractStorage {
      */
     protected Folder $folder;
 
+    /**
+     * The current generation.
+     *
+     * @var int
+     */
+    protected int $generation = 0;
+
+    /**
+     * Timestamp of when the generation was last read. The generation is re-read every second
+     * so that long running processes pick up flushes from other processes.
+     *
+     * @var int
+     */
+    protected int $generationTime = 0;
+
+    /**
+     * Open file handles for locks held by the current process.
+     *
+     * @var Map<string, resource>
+     */
+    protected Map<string, resource> $locks = Map {};
+
     /**
      * Set path through constructor.
      *
@@ -59,49 +106,150 @@ class FileSystemStorage extends AbstractStorage {
     }
 
     /**
+     * Increment the generation, which invalidates all items without deleting any files.
+     *
      * {@inheritdoc}
      */
     public function flush(): bool {
-        $this->files->clear();
-        $this->folder->flush();
+        $generation = $this->getGeneration() + 1;
 
-        clearstatcache();
+        if (!$this->writeFile($this->folder->path() . self::GENERATION_FILE, (string) $generation)) {
+            return false;
+        }
+
+        $this->generation = $generation;
+        $this->generationTime = time();
 
         return true;
     }
 
     /**
-     * {@inheritdoc}
+     * Return the current generation.
+     *
+     * @return int
      */
-    public function get(string $key): mixed {
-        if ($this->has($key)) {
-            return unserialize($this->readCache($key)['data']);
+    public function getGeneration(): int {
+        $time = time();
+
+        if ($this->generationTime !== $time) {
+            $this->generation = (int) @file_get_contents($this->folder->path() . self::GENERATION_FILE);
+            $this->generationTime = $time;
         }
 
-        throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
+        return $this->generation;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItem(string $key): Item {
+        $cache = $this->fetchCache($key, true);
+
+        return ($cache === null) ? new MissItem($key) : new HitItem($key, $this->getSerializer()->unserialize($cache['data']));
     }
 
     /**
+     * Only the expiration header is read.
+     *
      * {@inheritdoc}
      */
     public function has(string $key): bool {
-        if (file_exists($this->buildPath($this->getPrefix() . $key))) {
-            if ($this->readCache($key)['expires'] >= time()) {
-                return true;
-            } else {
-                $this->remove($key);
+        return ($this->fetchCache($key, false) !== null);
+    }
+
+    /**
+     * Read, update, and write the counter while holding an exclusive `flock()` on a mutex file.
+     *
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $handle = $this->acquireLock($this->buildLockPath($key, self::MUTEX_EXT), true);
+
+        if (!$handle) {
+            return parent::increment($key, $step, $initial);
+        }
+
+        $cache = $this->fetchCache($key, true);
+
+        if ($cache === null) {
+            $value = $initial + $step;
+            $expires = $this->getDefaultExpiration();
+        } else {
+            $value = (int) $this->getSerializer()->unserialize($cache['data']) + $step;
+            $expires = $cache['expires'];
+        }
+
+        $this->set($key, $value, $expires);
+        $this->releaseLock($handle);
+
+        return $value;
+    }
+
+    /**
+     * Acquire a non-blocking exclusive `flock()` on a lock file. The lock is released by the operating system
+     * if the process dies, so the TTL is not used.
+     *
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        if ($this->locks->contains($key)) {
+            return false;
+        }
+
+        $handle = $this->acquireLock($this->buildLockPath($key, self::LOCK_EXT), false);
+
+        if (!$handle) {
+            return false;
+        }
+
+        $this->locks[$key] = $handle;
+
+        return true;
+    }
+
+    /**
+     * Remove all previous generations, all expired files in the current generation, and all lock files
+     * that are not held. This should be called periodically outside of requests, as it walks the entire cache folder.
+     *
+     * @return bool
+     */
+    public function purge(): bool {
+        $current = (string) $this->getGeneration();
+        $time = time();
+
+        foreach ($this->folder->folders() as $folder) {
+            if ($folder->name() === self::LOCK_FOLDER) {
+                foreach ($folder->files(false, true) as $file) {
+                    if ($file->ext() === self::LOCK_EXT || $file->ext() === self::MUTEX_EXT) {
+                        $this->removeLock($file->path());
+                    }
+                }
+
+                continue;
+            }
+
+            if ($folder->name() !== $current) {
+                $folder->delete();
+                continue;
+            }
+
+            foreach ($folder->files(false, true) as $file) {
+                if ($file->ext() === 'cache' && $this->readExpiration($file->path()) < $time) {
+                    $file->delete();
+                }
             }
         }
 
-        return false;
+        clearstatcache();
+
+        return true;
     }
 
     /**
      * {@inheritdoc}
      */
     public function remove(string $key): bool {
-        $this->loadCache($key)->delete();
-        $this->files->remove($this->getPrefix() . $key);
+        @unlink($this->buildPath($key));
 
         return true;
     }
@@ -110,62 +258,237 @@ class FileSystemStorage extends AbstractStorage {
      * {@inheritdoc}
      */
     public function set(string $key, mixed $value, int $expires): bool {
-        return $this->loadCache($key)->write($expires . "\n" . serialize($value));
+        return $this->writeFile($this->buildPath($key), $expires . "\n" . $this->getSerializer()->serialize($value));
     }
 
     /**
-     * Build an absolute path to the cache on the file system using the defined key.
-     *
-     * @param string $key
-     * @return string
+     * {@inheritdoc}
      */
-    <<__Memoize>>
-    protected function buildPath(string $key): string {
-        $path = trim(preg_replace('/[^a-z0-9\-]+/is', '-', $key), '-');
-        $path = $this->folder->path() . $path . '.cache';
+    public function unlock(string $key): bool {
+        $handle = $this->locks->get($key);
 
-        return $path;
+        if ($handle === null) {
+            return false;
+        }
+
+        $this->releaseLock($handle);
+        $this->locks->remove($key);
+
+        return true;
     }
 
     /**
-     * Attempt to load a cache from the file system. If the cache does not exist, create it.
+     * Open a lock file and acquire an exclusive `flock()` on it. Return null if the lock could not be acquired,
+     * or if it is held by another handle and blocking is disabled.
      *
-     * @param string $key
-     * @return \Titon\Io\File
+     * Since `purge()` removes lock files that are not held, the lock file may be removed while waiting for it,
+     * in which case the lock is acquired again on the new lock file.
+     *
+     * @param string $path
+     * @param bool $block
+     * @return resource
      */
-    protected function loadCache(string $key): File {
-        $key = $this->getPrefix() . $key;
+    protected function acquireLock(string $path, bool $block): ?resource {
+        if (!$this->makeFolder(dirname($path))) {
+            return null;
+        }
+
+        for ($attempt = 0; $attempt < 3; $attempt++) {
+            $handle = @fopen($path, 'c');
+
+            if (!$handle) {
+                return null;
+            }
+
+            if (!flock($handle, $block ? LOCK_EX : (LOCK_EX | LOCK_NB))) {
+                fclose($handle);
+
+                return null;
+            }
+
+            clearstatcache(true, $path);
+
+            $stat = @stat($path);
+
+            if ($stat && $stat['ino'] === fstat($handle)['ino']) {
+                return $handle;
+            }
 
-        if ($this->files->contains($key)) {
-            return $this->files[$key];
+            $this->releaseLock($handle);
         }
 
-        return $this->files[$key] = new File($this->buildPath($key), true);
+        return null;
     }
 
     /**
-     * Load the cached file and return the expires timestamp and serialized data.
+     * Build an absolute path to a lock file of a key, with the given extension.
+     * Lock files do not belong to a generation.
      *
      * @param string $key
-     * @return \Titon\Cache\Storage\FileCache
+     * @param string $ext
+     * @return string
      */
-    protected function readCache(string $key): FileCache {
-        return $this->splitCache($this->loadCache($key)->read());
+    protected function buildLockPath(string $key, string $ext): string {
+        $hash = md5($this->getPrefix() . $key);
+
+        return sprintf('%s%s/%s/%s/%s.%s', $this->folder->path(), self::LOCK_FOLDER, substr($hash, 0, 2), substr($hash, 2, 2), $hash, $ext);
     }
 
     /**
-     * Split the cache into 2 separate parts, the expires timestamp, and the serialized data.
+     * Build an absolute path to the cache on the file system using a hash of the prefixed key.
+     * The first 4 characters of the hash are used as 2 levels of sharded folders.
      *
-     * @param string $cache
+     * @param string $key
+     * @return string
+     */
+    protected function buildPath(string $key): string {
+        $hash = md5($this->getPrefix() . $key);
+
+        return sprintf('%s%s/%s/%s/%s.cache', $this->folder->path(), $this->getGeneration(), substr($hash, 0, 2), substr($hash, 2, 2), $hash);
+    }
+
+    /**
+     * Read the expiration header of a cache file and optionally the payload.
+     * Return null if the file does not exist or has expired. Expired files are removed only if they are still
+     * expired, as another process may have replaced them, and while holding the mutex of the key, if it exists.
+     * Mutex files are not created for reads, as they only exist while, or after, the key is incremented.
+     *
+     * @param string $key
+     * @param bool $payload
      * @return \Titon\Cache\Storage\FileCache
      */
-    protected function splitCache(string $cache): FileCache {
-        list($expires, $data) = explode("\n", $cache, 2);
+    protected function fetchCache(string $key, bool $payload): ?FileCache {
+        $path = $this->buildPath($key);
+        $handle = @fopen($path, 'rb');
+
+        if (!$handle) {
+            return null;
+        }
+
+        $expires = (int) fgets($handle);
+
+        if ($expires < time()) {
+            fclose($handle);
+
+            $mutexPath = $this->buildLockPath($key, self::MUTEX_EXT);
+            $lock = null;
+
+            if (file_exists($mutexPath)) {
+                $lock = $this->acquireLock($mutexPath, false);
+
+                // The key is being incremented
+                if (!$lock) {
+                    return null;
+                }
+            }
+
+            if ($this->readExpiration($path) < time()) {
+                @unlink($path);
+            }
+
+            if ($lock) {
+                $this->releaseLock($lock);
+            }
+
+            return null;
+        }
+
+        $data = $payload ? (string) stream_get_contents($handle) : '';
+
+        fclose($handle);
 
         return shape(
-            'expires' => (int) $expires,
+            'expires' => $expires,
             'data' => $data
         );
     }
 
+    /**
+     * Create a folder and its parents if it does not exist.
+     *
+     * @param string $path
+     * @return bool
+     */
+    protected function makeFolder(string $path): bool {
+        return (is_dir($path) || @mkdir($path, 0755, true) || is_dir($path));
+    }
+
+    /**
+     * Read only the expiration header of a cache file.
+     *
+     * @param string $path
+     * @return int
+     */
+    protected function readExpiration(string $path): int {
+        $handle = @fopen($path, 'rb');
+
+        if (!$handle) {
+            return 0;
+        }
+
+        $expires = (int) fgets($handle);
+
+        fclose($handle);
+
+        return $expires;
+    }
+
+    /**
+     * Release a lock acquired with `acquireLock()` and close its handle.
+     *
+     * @param resource $handle
+     */
+    protected function releaseLock(resource $handle): void {
+        flock($handle, LOCK_UN);
+        fclose($handle);
+    }
+
+    /**
+     * Remove a lock file if it is not held by any process. The file is removed while holding its lock,
+     * so that processes waiting for it will notice and acquire the lock on a new file instead.
+     *
+     * @param string $path
+     */
+    protected function removeLock(string $path): void {
+        $handle = @fopen($path, 'c');
+
+        if (!$handle) {
+            return;
+        }
+
+        if (flock($handle, LOCK_EX | LOCK_NB)) {
+            @unlink($path);
+        }
+
+        $this->releaseLock($handle);
+    }
+
+    /**
+     * Write data to a temporary file and rename it to the target path, which is atomic,
+     * so that readers either see the previous or the new file, but never a partial write.
+     *
+     * @param string $path
+     * @param string $data
+     * @return bool
+     */
+    protected function writeFile(string $path, string $data): bool {
+        if (!$this->makeFolder(dirname($path))) {
+            return false;
+        }
+
+        $temp = $path . '.' . uniqid('', true) . '.tmp';
+
+        if (file_put_contents($temp, $data) === false) {
+            return false;
+        }
+
+        if (!rename($temp, $path)) {
+            @unlink($temp);
+
+            return false;
+        }
+
+        return true;
+    }
+
 }
@@ -0,0 +1,421 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\Item;
+use Titon\Cache\ItemMap;
+use Titon\Cache\Metrics;
+use Titon\Cache\Sink;
+use Titon\Cache\StatsMap;
+use Titon\Cache\Storage;
+use Titon\Cache\ValueMap;
+
+/**
+ * A storage engine that wraps another storage engine and records hits, misses, sets, optionally the estimated
+ * bytes read and written, and a latency histogram for each operation. The metrics are available through `stats()`,
+ * and are reported to a sink once the request has finished.
+ *
+ * {{{
+ *        new InstrumentedStorage(new RedisStorage(new Redis()), new StatsdSink(), 'sessions');
+ * }}}
+ *
+ * Byte sizes are estimated from the serialized length of each value, which serializes every value a second time,
+ * so they are only counted when enabled.
+ *
+ * @package Titon\Cache\Storage
+ */
+class InstrumentedStorage extends AbstractStorage {
+
+    /**
+     * Whether to count the estimated bytes read and written.
+     *
+     * @var bool
+     */
+    protected bool $countBytes;
+
+    /**
+     * The collected metrics.
+     *
+     * @var \Titon\Cache\Metrics
+     */
+    protected Metrics $metrics;
+
+    /**
+     * Name of the storage, used when reporting.
+     *
+     * @var string
+     */
+    protected string $name;
+
+    /**
+     * The sink to report metrics to.
+     *
+     * @var \Titon\Cache\Sink
+     */
+    protected ?Sink $sink;
+
+    /**
+     * The storage engine being instrumented.
+     *
+     * @var \Titon\Cache\Storage
+     */
+    protected Storage $storage;
+
+    /**
+     * Set the storage, sink, and name, and whether to count bytes. If a sink is defined, metrics are reported
+     * after the response has been sent to the client, or on shutdown.
+     *
+     * @param \Titon\Cache\Storage $storage
+     * @param \Titon\Cache\Sink $sink
+     * @param string $name
+     * @param bool $countBytes
+     */
+    public function __construct(Storage $storage, ?Sink $sink = null, string $name = 'default', bool $countBytes = false) {
+        $this->storage = $storage;
+        $this->sink = $sink;
+        $this->name = $name;
+        $this->countBytes = $countBytes;
+        $this->metrics = new Metrics();
+
+        // The parent constructor is not called, as the prefix belongs to the instrumented storage
+
+        if ($sink) {
+            $callback = () ==> {
+                $this->report();
+            };
+
+            if (function_exists('register_postsend_function')) {
+                register_postsend_function($callback);
+            } else {
+                register_shutdown_function($callback);
+            }
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function flush(): bool {
+        $start = microtime(true);
+        $flushed = $this->getStorage()->flush();
+
+        $this->measure('flush', $start);
+
+        return $flushed;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genGetItem(string $key): Awaitable<Item> {
+        $start = microtime(true);
+        $item = await $this->getStorage()->genGetItem($key);
+
+        $this->measure('getItem', $start);
+        $this->countItem($item);
+
+        return $item;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genGetItems(array<string> $keys = []): Awaitable<ItemMap> {
+        $start = microtime(true);
+        $items = await $this->getStorage()->genGetItems($keys);
+
+        $this->measure('getMany', $start);
+
+        foreach ($items as $item) {
+            $this->countItem($item);
+        }
+
+        return $items;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genSave(Item $item): Awaitable<this> {
+        $start = microtime(true);
+
+        await $this->getStorage()->genSave($item);
+
+        $this->measure('set', $start);
+        $this->countWrite($item->get());
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItem(string $key): Item {
+        $start = microtime(true);
+        $item = $this->getStorage()->getItem($key);
+
+        $this->measure('getItem', $start);
+        $this->countItem($item);
+
+        return $item;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $start = microtime(true);
+        $values = $this->getStorage()->getMany($keys);
+
+        $this->measure('getMany', $start);
+        $this->metrics->count(self::MISSES, count($keys) - $values->count());
+
+        foreach ($values as $value) {
+            $this->countRead($value);
+        }
+
+        return $values;
+    }
+
+    /**
+     * Return the collected metrics.
+     *
+     * @return \Titon\Cache\Metrics
+     */
+    public function getMetrics(): Metrics {
+        return $this->metrics;
+    }
+
+    /**
+     * Return the name of the storage.
+     *
+     * @return string
+     */
+    public function getName(): string {
+        return $this->name;
+    }
+
+    /**
+     * Return the prefix of the instrumented storage.
+     *
+     * {@inheritdoc}
+     */
+    public function getPrefix(): string {
+        return $this->getStorage()->getPrefix();
+    }
+
+    /**
+     * Return the sink.
+     *
+     * @return \Titon\Cache\Sink
+     */
+    public function getSink(): ?Sink {
+        return $this->sink;
+    }
+
+    /**
+     * Return the storage engine being instrumented.
+     *
+     * @return \Titon\Cache\Storage
+     */
+    public function getStorage(): Storage {
+        return $this->storage;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function has(string $key): bool {
+        $start = microtime(true);
+        $exists = $this->getStorage()->has($key);
+
+        $this->measure('has', $start);
+
+        return $exists;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $start = microtime(true);
+        $value = $this->getStorage()->increment($key, $step, $initial);
+
+        $this->measure('increment', $start);
+
+        return $value;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        $start = microtime(true);
+        $locked = $this->getStorage()->lock($key, $ttl);
+
+        $this->measure('lock', $start);
+
+        return $locked;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function remove(string $key): bool {
+        $start = microtime(true);
+        $removed = $this->getStorage()->remove($key);
+
+        $this->measure('remove', $start);
+
+        return $removed;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        $start = microtime(true);
+        $removed = $this->getStorage()->removeMany($keys);
+
+        $this->measure('removeMany', $start);
+
+        return $removed;
+    }
+
+    /**
+     * Report the metrics collected since the last report to the sink, and reset them.
+     *
+     * @return $this
+     */
+    public function report(): this {
+        if ($this->sink) {
+            $this->sink->report($this->getName(), $this->metrics);
+            $this->metrics->reset();
+        }
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function set(string $key, mixed $value, int $expires): bool {
+        $start = microtime(true);
+        $saved = $this->getStorage()->set($key, $value, $expires);
+
+        $this->measure('set', $start);
+        $this->countWrite($value);
+
+        return $saved;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $start = microtime(true);
+        $saved = $this->getStorage()->setMany($values, $expires);
+
+        $this->measure('setMany', $start);
+
+        foreach ($values as $value) {
+            $this->countWrite($value);
+        }
+
+        return $saved;
+    }
+
+    /**
+     * Set the prefix of the instrumented storage.
+     *
+     * {@inheritdoc}
+     */
+    public function setPrefix(string $prefix): this {
+        $this->getStorage()->setPrefix($prefix);
+
+        return $this;
+    }
+
+    /**
+     * Return the statistics of the instrumented storage, merged with the collected metrics.
+     * Hits and misses are those of the current process.
+     *
+     * {@inheritdoc}
+     */
+    public function stats(): StatsMap {
+        $stats = $this->getStorage()->stats();
+
+        foreach ($this->metrics->toMap() as $key => $value) {
+            $stats[$key] = $value;
+        }
+
+        return $stats;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unlock(string $key): bool {
+        $start = microtime(true);
+        $unlocked = $this->getStorage()->unlock($key);
+
+        $this->measure('unlock', $start);
+
+        return $unlocked;
+    }
+
+    /**
+     * Count a hit or miss, and the bytes read for a hit.
+     *
+     * @param \Titon\Cache\Item $item
+     */
+    protected function countItem(Item $item): void {
+        if ($item->isHit()) {
+            $this->countRead($item->get());
+        } else {
+            $this->metrics->count(self::MISSES);
+        }
+    }
+
+    /**
+     * Count a hit, and the estimated bytes read if enabled.
+     *
+     * @param mixed $value
+     */
+    protected function countRead(mixed $value): void {
+        $this->metrics->count(self::HITS);
+
+        if ($this->countBytes) {
+            $this->metrics->count(self::BYTES_READ, strlen(serialize($value)));
+        }
+    }
+
+    /**
+     * Count a set, and the estimated bytes written if enabled.
+     *
+     * @param mixed $value
+     */
+    protected function countWrite(mixed $value): void {
+        $this->metrics->count(self::SETS);
+
+        if ($this->countBytes) {
+            $this->metrics->count(self::BYTES_WRITTEN, strlen(serialize($value)));
+        }
+    }
+
+    /**
+     * Record the duration of an operation that started at the defined time.
+     *
+     * @param string $operation
+     * @param float $start
+     */
+    protected function measure(string $operation, float $start): void {
+        $this->metrics->time($operation, microtime(true) - $start);
+    }
+
+}
@@ -0,0 +1,226 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\ItemMap;
+use Titon\Cache\MissItem;
+use Titon\Cache\StatsMap;
+use Titon\Cache\ValueMap;
+use \MCRouter;
+use \MCRouterException;
+
+/**
+ * A storage engine for Memcache that uses the non-blocking mcrouter client built into HHVM.
+ * Every operation is asynchronous, so multiple lookups can be awaited in parallel using the `gen*()` methods,
+ * while the synchronous methods wait for the result.
+ *
+ * {{{
+ *        new McrouterStorage(MCRouter::createSimple(Vector {'127.0.0.1:11211'}));
+ * }}}
+ *
+ * @link http://docs.hhvm.com/manual/en/class.mcrouter.php
+ *
+ * @package Titon\Cache\Storage
+ */
+class McrouterStorage extends AbstractStorage {
+
+    /**
+     * The mcrouter client.
+     *
+     * @var \MCRouter
+     */
+    protected MCRouter $mcrouter;
+
+    /**
+     * Set the MCRouter instance.
+     *
+     * @param \MCRouter $mcrouter
+     * @param string $prefix
+     */
+    public function __construct(MCRouter $mcrouter, string $prefix = '') {
+        $this->mcrouter = $mcrouter;
+
+        parent::__construct($prefix);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function flush(): bool {
+        try {
+            $this->getMcrouter()->genFlushAll()->getWaitHandle()->join();
+        } catch (MCRouterException $e) {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Misses are reported by mcrouter as exceptions.
+     *
+     * {@inheritdoc}
+     */
+    public async function genGetItem(string $key): Awaitable<Item> {
+        try {
+            $value = await $this->getMcrouter()->genGet($this->getPrefix() . $key);
+        } catch (MCRouterException $e) {
+            return new MissItem($key);
+        }
+
+        return new HitItem($key, $this->decode($value));
+    }
+
+    /**
+     * Each item is fetched in parallel.
+     *
+     * {@inheritdoc}
+     */
+    public async function genGetItems(array<string> $keys = []): Awaitable<ItemMap> {
+        $handles = Map {};
+
+        foreach ($keys as $key) {
+            $handles[$key] = $this->genGetItem($key)->getWaitHandle();
+        }
+
+        return await GenMapWaitHandle::create($handles);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItem(string $key): Item {
+        return $this->genGetItem($key)->getWaitHandle()->join();
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItems(array<string> $keys = []): ItemMap {
+        return $this->genGetItems($keys)->getWaitHandle()->join();
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
+
+        foreach ($this->getItems($keys) as $key => $item) {
+            if ($item->isHit()) {
+                $values[$key] = $item->get();
+            }
+        }
+
+        return $values;
+    }
+
+    /**
+     * Return the MCRouter instance.
+     *
+     * @return \MCRouter
+     */
+    public function getMcrouter(): MCRouter {
+        return $this->mcrouter;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function has(string $key): bool {
+        return $this->getItem($key)->isHit();
+    }
+
+    /**
+     * Memcache counters are unsigned, so negative steps fall back to the non-atomic implementation.
+     *
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        if ($step < 0) {
+            return parent::increment($key, $step, $initial);
+        }
+
+        $mcrouter = $this->getMcrouter();
+        $prefixedKey = $this->getPrefix() . $key;
+
+        try {
+            return $mcrouter->genIncr($prefixedKey, $step)->getWaitHandle()->join();
+        } catch (MCRouterException $e) {
+            // Counter does not exist
+        }
+
+        try {
+            $mcrouter->genAdd($prefixedKey, (string) ($initial + $step), 0, $this->getDefaultExpiration())->getWaitHandle()->join();
+
+            return $initial + $step;
+        } catch (MCRouterException $e) {
+            // Counter was created by another process
+        }
+
+        return $mcrouter->genIncr($prefixedKey, $step)->getWaitHandle()->join();
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        try {
+            $this->getMcrouter()->genAdd($this->getPrefix() . $key . '.lock', '1', 0, $ttl)->getWaitHandle()->join();
+        } catch (MCRouterException $e) {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function remove(string $key): bool {
+        try {
+            $this->getMcrouter()->genDel($this->getPrefix() . $key)->getWaitHandle()->join();
+        } catch (MCRouterException $e) {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function set(string $key, mixed $value, int $expires): bool {
+        return $this->genSet($key, $value, $expires)->getWaitHandle()->join();
+    }
+
+    /**
+     * The mcrouter client does not expose server statistics.
+     *
+     * {@inheritdoc}
+     */
+    public function stats(): StatsMap {
+        return Map {};
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    protected async function genSet(string $key, mixed $value, int $expires): Awaitable<bool> {
+        try {
+            await $this->getMcrouter()->genSet($this->getPrefix() . $key, $this->encode($value), 0, $expires);
+        } catch (MCRouterException $e) {
+            return false;
+        }
+
+        return true;
+    }
+
+}
@@ -7,8 +7,12 @@
 
 namespace Titon\Cache\Storage;
 
-use Titon\Cache\Exception\MissingItemException;
+use Titon\Cache\Exception\InvalidItemException;
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
 use Titon\Cache\StatsMap;
+use Titon\Cache\ValueMap;
 use \Memcached;
 
 /**
@@ -54,14 +58,40 @@ class MemcacheStorage extends AbstractStorage {
     /**
      * {@inheritdoc}
      */
-    public function get(string $key): mixed {
+    public function getItem(string $key): Item {
         $value = $this->getMemcache()->get($this->getPrefix() . $key);
 
         if ($value === false && $this->getMemcache()->getResultCode() === Memcached::RES_NOTFOUND) {
-            throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
+            return new MissItem($key);
         }
 
-        return $value;
+        return new HitItem($key, $value);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
+
+        if (!$keys) {
+            return $values;
+        }
+
+        $prefixed = $this->prefixKeys($keys);
+        $fetched = $this->getMemcache()->getMulti($prefixed->keys()->toArray());
+
+        if (!is_array($fetched)) {
+            return $values;
+        }
+
+        foreach ($prefixed as $prefixedKey => $key) {
+            if (array_key_exists($prefixedKey, $fetched)) {
+                $values[$key] = $fetched[$prefixedKey];
+            }
+        }
+
+        return $values;
     }
 
     /**
@@ -83,6 +113,44 @@ class MemcacheStorage extends AbstractStorage {
         );
     }
 
+    /**
+     * Memcached counters are unsigned, so negative steps and values are updated using compare-and-swap.
+     *
+     * {@inheritdoc}
+     * @throws \Titon\Cache\Exception\InvalidItemException
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $memcache = $this->getMemcache();
+        $key = $this->getPrefix() . $key;
+
+        if ($step >= 0) {
+            $value = $memcache->increment($key, $step);
+
+            if ($value !== false) {
+                return (int) $value;
+            }
+
+            if ($memcache->getResultCode() === Memcached::RES_NOTFOUND && $memcache->add($key, $initial + $step, $this->getDefaultExpiration())) {
+                return $initial + $step;
+            }
+        }
+
+        $value = $this->compareAndSwap($key, $step, $initial);
+
+        if ($value === null) {
+            throw new InvalidItemException(sprintf('Failed to increment %s, result code %s', $key, $memcache->getResultCode()));
+        }
+
+        return $value;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        return $this->getMemcache()->add($this->getPrefix() . $key . '.lock', 1, $ttl);
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -90,6 +158,20 @@ class MemcacheStorage extends AbstractStorage {
         return $this->getMemcache()->delete($this->getPrefix() . $key);
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        if (!$keys) {
+            return true;
+        }
+
+        $results = $this->getMemcache()->deleteMulti($this->prefixKeys($keys)->keys()->toArray());
+
+        // Each key maps to true, or a result code on failure
+        return !array_filter($results, $result ==> $result !== true);
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -97,6 +179,25 @@ class MemcacheStorage extends AbstractStorage {
         return $this->getMemcache()->set($this->getPrefix() . $key, $value, $expires);
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $data = [];
+
+        $prefix = $this->getPrefix();
+
+        foreach ($values as $key => $value) {
+            $data[$prefix . $key] = $value;
+        }
+
+        if (!$data) {
+            return true;
+        }
+
+        return $this->getMemcache()->setMulti($data, $expires);
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -114,4 +215,58 @@ class MemcacheStorage extends AbstractStorage {
         };
     }
 
+    /**
+     * Add a step to a counter using compare-and-swap, and retry if another process created, changed,
+     * or removed it in the meantime. Return null if any other error occurs, or if the counter is still
+     * contended after the maximum number of attempts.
+     * Since Memcached cannot return the expiration of an item, the default expiration is used.
+     *
+     * @param string $key
+     * @param int $step
+     * @param int $initial
+     * @param int $maxAttempts
+     * @return int
+     */
+    protected function compareAndSwap(string $key, int $step, int $initial, int $maxAttempts = 10): ?int {
+        $memcache = $this->getMemcache();
+
+        for ($attempt = 0; $attempt < $maxAttempts; $attempt++) {
+            $token = null;
+            $current = $memcache->get($key, null, $token);
+
+            if ($current === false && $memcache->getResultCode() !== Memcached::RES_SUCCESS) {
+                if ($memcache->getResultCode() !== Memcached::RES_NOTFOUND) {
+                    return null;
+                }
+
+                $value = $initial + $step;
+
+                if ($memcache->add($key, $value, $this->getDefaultExpiration())) {
+                    return $value;
+                }
+
+                // Created by another process
+                if ($memcache->getResultCode() !== Memcached::RES_NOTSTORED) {
+                    return null;
+                }
+
+            } else {
+                $value = (int) $current + $step;
+
+                if ($memcache->cas($token, $key, $value, $this->getDefaultExpiration())) {
+                    return $value;
+                }
+
+                // Changed or removed by another process
+                $code = $memcache->getResultCode();
+
+                if ($code !== Memcached::RES_DATA_EXISTS && $code !== Memcached::RES_NOTFOUND) {
+                    return null;
+                }
+            }
+        }
+
+        return null;
+    }
+
 }
@@ -7,22 +7,98 @@
 
 namespace Titon\Cache\Storage;
 
-use Titon\Cache\Exception\MissingItemException;
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
+use Titon\Cache\StatsMap;
 use Titon\Common\Cacheable;
 
 /**
  * A lightweight caching engine that stores data in memory for the duration of the HTTP request.
  *
+ * Expired items are never returned, while items with an expiration of 0 never expire. For long running processes,
+ * the storage can be bounded by a maximum number of items and a byte budget, at which point the least recently used
+ * items are evicted.
+ *
+ * {{{
+ *        new MemoryStorage('prefix-', 1000, 1048576);
+ * }}}
+ *
  * @package Titon\Cache\Storage
  */
 class MemoryStorage extends AbstractStorage {
     use Cacheable;
 
+    /**
+     * Estimated size in bytes of all items, only tracked when a byte budget is set.
+     *
+     * @var int
+     */
+    protected int $bytes = 0;
+
+    /**
+     * Expiration and size of each item, ordered from least to most recently used.
+     *
+     * @var \Titon\Cache\Storage\MemoryEntryMap
+     */
+    protected MemoryEntryMap $entries = Map {};
+
+    /**
+     * Number of items evicted to stay within the limits.
+     *
+     * @var int
+     */
+    protected int $evictions = 0;
+
+    /**
+     * Number of successful reads.
+     *
+     * @var int
+     */
+    protected int $hits = 0;
+
+    /**
+     * Maximum estimated size in bytes of all items, or 0 for no limit.
+     *
+     * @var int
+     */
+    protected int $maxBytes;
+
+    /**
+     * Maximum number of items, or 0 for no limit.
+     *
+     * @var int
+     */
+    protected int $maxItems;
+
+    /**
+     * Number of failed reads.
+     *
+     * @var int
+     */
+    protected int $misses = 0;
+
+    /**
+     * Set the prefix and limits.
+     *
+     * @param string $prefix
+     * @param int $maxItems
+     * @param int $maxBytes
+     */
+    public function __construct(string $prefix = '', int $maxItems = 0, int $maxBytes = 0) {
+        $this->maxItems = max(0, $maxItems);
+        $this->maxBytes = max(0, $maxBytes);
+
+        parent::__construct($prefix);
+    }
+
     /**
      * {@inheritdoc}
      */
     public function flush(): bool {
         $this->flushCache();
+        $this->entries->clear();
+        $this->bytes = 0;
 
         return true;
     }
@@ -30,26 +106,77 @@ class MemoryStorage extends AbstractStorage {
     /**
      * {@inheritdoc}
      */
-    public function get(string $key): mixed {
-        if ($this->has($key)) {
-            return $this->getCache($this->getPrefix() . $key);
+    public function getItem(string $key): Item {
+        $cacheKey = $this->createCacheKey($this->getPrefix() . $key);
+
+        if (!$this->isAlive($cacheKey)) {
+            $this->misses++;
+
+            return new MissItem($key);
         }
 
-        throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
+        $this->hits++;
+
+        // Move to the end of the list
+        if ($this->isBounded()) {
+            $entry = $this->entries[$cacheKey];
+
+            $this->entries->remove($cacheKey);
+            $this->entries[$cacheKey] = $entry;
+        }
+
+        return new HitItem($key, $this->getCache($cacheKey));
+    }
+
+    /**
+     * Return the maximum estimated size in bytes of all items.
+     *
+     * @return int
+     */
+    public function getMaxBytes(): int {
+        return $this->maxBytes;
+    }
+
+    /**
+     * Return the maximum number of items.
+     *
+     * @return int
+     */
+    public function getMaxItems(): int {
+        return $this->maxItems;
     }
 
     /**
      * {@inheritdoc}
      */
     public function has(string $key): bool {
-        return $this->hasCache($this->getPrefix() . $key);
+        return $this->isAlive($this->createCacheKey($this->getPrefix() . $key));
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $cacheKey = $this->createCacheKey($this->getPrefix() . $key);
+
+        if ($this->isAlive($cacheKey)) {
+            $value = (int) $this->getCache($cacheKey) + $step;
+            $expires = $this->entries[$cacheKey]['expires'];
+        } else {
+            $value = $initial + $step;
+            $expires = $this->getDefaultExpiration();
+        }
+
+        $this->set($key, $value, $expires);
+
+        return $value;
     }
 
     /**
      * {@inheritdoc}
      */
     public function remove(string $key): bool {
-        $this->removeCache($this->getPrefix() . $key);
+        $this->removeEntry($this->createCacheKey($this->getPrefix() . $key));
 
         return true;
     }
@@ -58,9 +185,129 @@ class MemoryStorage extends AbstractStorage {
      * {@inheritdoc}
      */
     public function set(string $key, mixed $value, int $expires): bool {
-        $this->setCache($this->getPrefix() . $key, $value);
+        $key = $this->createCacheKey($this->getPrefix() . $key);
+        $size = $this->maxBytes ? strlen(serialize($value)) : 0;
+
+        $this->removeEntry($key);
+
+        if ($this->maxBytes && $size > $this->maxBytes) {
+            return false;
+        }
+
+        $this->setCache($key, $value);
+        $this->entries[$key] = shape('expires' => $expires, 'size' => $size);
+        $this->bytes += $size;
+
+        $this->evict();
+
+        return true;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function stats(): StatsMap {
+        return Map {
+            self::HITS => $this->hits,
+            self::MISSES => $this->misses,
+            self::EVICTIONS => $this->evictions,
+            self::ITEMS => $this->entries->count(),
+            self::MEMORY_USAGE => $this->bytes,
+            self::MEMORY_AVAILABLE => $this->maxBytes ? ($this->maxBytes - $this->bytes) : false
+        };
+    }
+
+    /**
+     * Remove expired items, and then the least recently used items, until the storage is within its limits.
+     */
+    protected function evict(): void {
+        if (!$this->isOverLimit()) {
+            return;
+        }
+
+        $time = time();
+
+        foreach ($this->entries->toMap() as $key => $entry) {
+            if ($this->isExpired($entry, $time)) {
+                $this->removeEntry($key);
+            }
+        }
+
+        while ($this->entries && $this->isOverLimit()) {
+            $this->removeEntry($this->entries->firstKey());
+            $this->evictions++;
+        }
+    }
+
+    /**
+     * Return true if the item exists and has not expired. Expired items are removed.
+     *
+     * @param string $key
+     * @return bool
+     */
+    protected function isAlive(string $key): bool {
+        $entry = $this->entries->get($key);
+
+        if ($entry === null) {
+            return false;
+        }
+
+        if ($this->isExpired($entry, time())) {
+            $this->removeEntry($key);
+
+            return false;
+        }
 
         return true;
     }
 
+    /**
+     * Return true if a maximum number of items or a byte budget has been set.
+     *
+     * @return bool
+     */
+    protected function isBounded(): bool {
+        return ($this->maxItems > 0 || $this->maxBytes > 0);
+    }
+
+    /**
+     * Return true if an entry has expired. An expiration of 0 means the entry never expires,
+     * the same as the Memcache and Redis backends.
+     *
+     * @param \Titon\Cache\Storage\MemoryEntry $entry
+     * @param int $time
+     * @return bool
+     */
+    protected function isExpired(MemoryEntry $entry, int $time): bool {
+        return ($entry['expires'] > 0 && $entry['expires'] < $time);
+    }
+
+    /**
+     * Return true if the storage has exceeded its limits.
+     *
+     * @return bool
+     */
+    protected function isOverLimit(): bool {
+        return (
+            ($this->maxItems > 0 && $this->entries->count() > $this->maxItems) ||
+            ($this->maxBytes > 0 && $this->bytes > $this->maxBytes)
+        );
+    }
+
+    /**
+     * Remove an item and its entry using a fully prefixed key.
+     *
+     * @param string $key
+     */
+    protected function removeEntry(string $key): void {
+        $entry = $this->entries->get($key);
+
+        if ($entry !== null) {
+            $this->bytes -= $entry['size'];
+            $this->entries->remove($key);
+        }
+
+        $this->removeCache($key);
+    }
+
 }
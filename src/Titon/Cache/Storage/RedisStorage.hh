@@ -7,8 +7,11 @@
 
 namespace Titon\Cache\Storage;
 
-use Titon\Cache\Exception\MissingItemException;
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
 use Titon\Cache\StatsMap;
+use Titon\Cache\ValueMap;
 use \Redis;
 
 /**
@@ -54,14 +57,36 @@ class RedisStorage extends AbstractStorage {
     /**
      * {@inheritdoc}
      */
-    public function get(string $key): mixed {
+    public function getItem(string $key): Item {
         $value = $this->getRedis()->get($this->getPrefix() . $key);
 
-        if ($value === false) {
-            throw new MissingItemException(sprintf('Item with key %s does not exist', $key));
+        return ($value === false) ? new MissItem($key) : new HitItem($key, $this->decode($value));
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
+
+        if (!$keys) {
+            return $values;
+        }
+
+        $prefixed = $this->prefixKeys($keys);
+        $fetched = $this->getRedis()->mget($prefixed->keys()->toArray());
+        $i = 0;
+
+        // Results are returned in the same order as the keys, with false for missing keys
+        foreach ($prefixed as $key) {
+            if (array_key_exists($i, $fetched) && $fetched[$i] !== false) {
+                $values[$key] = $this->decode($fetched[$i]);
+            }
+
+            $i++;
         }
 
-        return unserialize($value);
+        return $values;
     }
 
     /**
@@ -80,6 +105,28 @@ class RedisStorage extends AbstractStorage {
         return $this->getRedis()->exists($this->getPrefix() . $key);
     }
 
+    /**
+     * Create the counter if it does not exist and increment it within a single pipelined round trip.
+     *
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $key = $this->getPrefix() . $key;
+        $pipeline = $this->getRedis()->multi(Redis::PIPELINE);
+
+        $pipeline->set($key, $initial, ['nx', 'ex' => $this->getDefaultExpiration() - time()]);
+        $pipeline->incrBy($key, $step);
+
+        return (int) $pipeline->exec()[1];
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        return (bool) $this->getRedis()->set($this->getPrefix() . $key . '.lock', 1, ['nx', 'ex' => $ttl]);
+    }
+
     /**
      * {@inheritdoc}
      */
@@ -87,11 +134,41 @@ class RedisStorage extends AbstractStorage {
         return (bool) $this->getRedis()->delete($this->getPrefix() . $key);
     }
 
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        if (!$keys) {
+            return true;
+        }
+
+        return (bool) $this->getRedis()->delete($this->prefixKeys($keys)->keys()->toArray());
+    }
+
     /**
      * {@inheritdoc}
      */
     public function set(string $key, mixed $value, int $expires): bool {
-        return $this->getRedis()->setex($this->getPrefix() . $key, $expires - time(), serialize($value)); // Redis is TTL
+        return $this->getRedis()->setex($this->getPrefix() . $key, $expires - time(), $this->encode($value)); // Redis is TTL
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        if (!$values) {
+            return true;
+        }
+
+        $ttl = $expires - time();
+        $prefix = $this->getPrefix();
+        $pipeline = $this->getRedis()->multi(Redis::PIPELINE);
+
+        foreach ($values as $key => $value) {
+            $pipeline->setex($prefix . $key, $ttl, $this->encode($value));
+        }
+
+        return !in_array(false, $pipeline->exec(), true);
     }
 
     /**
@@ -0,0 +1,639 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\Exception\CorruptedItemException;
+use Titon\Cache\Exception\InvalidItemException;
+use Titon\Cache\Exception\MissingItemException;
+use Titon\Cache\Exception\MissingStorageException;
+use Titon\Cache\Exception\UnsupportedOperationException;
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\ItemMap;
+use Titon\Cache\MissItem;
+use Titon\Cache\StatsMap;
+use Titon\Cache\Storage;
+use Titon\Cache\StorageMap;
+use Titon\Cache\ValueMap;
+use \Exception;
+
+/**
+ * A storage engine that distributes keys over multiple storage engines (nodes) using a consistent hash ring.
+ * Each node is placed on the ring multiple times (virtual nodes) in proportion to its weight, so that keys
+ * are spread evenly, and adding or removing a node only remaps the keys of that node.
+ *
+ * {{{
+ *        $storage = new ShardedStorage(Map {
+ *            'redis1' => new RedisStorage($redis1),
+ *            'redis2' => new RedisStorage($redis2)
+ *        });
+ *        $storage->addNode('redis3', new RedisStorage($redis3), 2);
+ * }}}
+ *
+ * If a node throws an exception, like a connection error, it is marked as failed for the retry interval, during which
+ * its keys are remapped to the next node on the ring. Exceptions caused by the item itself, like corrupted data,
+ * are rethrown instead, as another node would not fix them.
+ *
+ * Batch operations are grouped and sent once per node. Reads are fanned out to all nodes in parallel with
+ * `genGetItems()`, which is only concurrent for nodes with an async client, as other storage engines block.
+ * Writes and removals are sent to each node in turn, as storage engines have no async batch writes.
+ *
+ * @package Titon\Cache\Storage
+ */
+class ShardedStorage extends AbstractStorage {
+
+    /**
+     * Timestamps of when failed nodes can be retried, keyed by node name.
+     *
+     * @var Map<string, int>
+     */
+    protected Map<string, int> $failed = Map {};
+
+    /**
+     * Storage engines keyed by node name.
+     *
+     * @var \Titon\Cache\StorageMap
+     */
+    protected StorageMap $nodes = Map {};
+
+    /**
+     * Sorted hashes of each virtual node.
+     *
+     * @var array<int>
+     */
+    protected array<int> $points = [];
+
+    /**
+     * Number of virtual nodes per unit of weight.
+     *
+     * @var int
+     */
+    protected int $replicas;
+
+    /**
+     * Number of seconds before a failed node is retried.
+     *
+     * @var int
+     */
+    protected int $retry;
+
+    /**
+     * Node name for each virtual node hash. Is built lazily when nodes change.
+     *
+     * @var array<int, string>
+     */
+    protected array<int, string> $ring = [];
+
+    /**
+     * Weight of each node keyed by node name.
+     *
+     * @var Map<string, int>
+     */
+    protected Map<string, int> $weights = Map {};
+
+    /**
+     * Set the nodes, the number of virtual nodes per unit of weight, and the retry interval for failed nodes.
+     *
+     * @param \Titon\Cache\StorageMap $nodes
+     * @param int $replicas
+     * @param int $retry
+     * @param string $prefix
+     */
+    public function __construct(StorageMap $nodes = Map {}, int $replicas = 160, int $retry = 30, string $prefix = '') {
+        $this->replicas = max(1, $replicas);
+        $this->retry = max(1, $retry);
+
+        foreach ($nodes as $name => $storage) {
+            $this->addNode($name, $storage);
+        }
+
+        parent::__construct($prefix);
+    }
+
+    /**
+     * Add a node to the ring. A node with a weight of 2 receives twice as many keys as a node with a weight of 1.
+     *
+     * @param string $name
+     * @param \Titon\Cache\Storage $storage
+     * @param int $weight
+     * @return $this
+     */
+    public function addNode(string $name, Storage $storage, int $weight = 1): this {
+        $this->nodes[$name] = $storage;
+        $this->weights[$name] = max(1, $weight);
+        $this->ring = [];
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function flush(): bool {
+        $flushed = true;
+
+        foreach ($this->nodes as $name => $storage) {
+            if (!$this->isAvailable($name)) {
+                continue;
+            }
+
+            try {
+                $flushed = $storage->flush() && $flushed;
+            } catch (Exception $e) {
+                $this->handleFailure($name, $e);
+                $flushed = false;
+            }
+        }
+
+        return $flushed;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public async function genGetItem(string $key): Awaitable<Item> {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            $item = await $this->nodes[$name]->genGetItem($shardedKey);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return await $this->genGetItem($key);
+        }
+
+        return $item->isHit() ? new HitItem($key, $item->get()) : new MissItem($key);
+    }
+
+    /**
+     * Items are fetched from every node in parallel.
+     *
+     * {@inheritdoc}
+     */
+    public async function genGetItems(array<string> $keys = []): Awaitable<ItemMap> {
+        $handles = Map {};
+
+        foreach ($this->groupKeys($keys) as $name => $nodeKeys) {
+            $handles[$name] = $this->genGetNodeItems($name, $nodeKeys)->getWaitHandle();
+        }
+
+        $results = await GenMapWaitHandle::create($handles);
+        $items = Map {};
+
+        // Return the items in the order of the keys
+        foreach ($keys as $key) {
+            foreach ($results as $found) {
+                if ($found->contains($key)) {
+                    $items[$key] = $found[$key];
+                    break;
+                }
+            }
+        }
+
+        return $items;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItem(string $key): Item {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            $item = $this->nodes[$name]->getItem($shardedKey);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->getItem($key);
+        }
+
+        return $item->isHit() ? new HitItem($key, $item->get()) : new MissItem($key);
+    }
+
+    /**
+     * Values are fetched from every node in parallel using `genGetItems()`.
+     *
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
+
+        foreach ($this->genGetItems($keys)->getWaitHandle()->join() as $key => $item) {
+            if ($item->isHit()) {
+                $values[$key] = $item->get();
+            }
+        }
+
+        return $values;
+    }
+
+    /**
+     * Return the storage engine that a key is mapped to.
+     *
+     * @param string $key
+     * @return \Titon\Cache\Storage
+     * @throws \Titon\Cache\Exception\MissingStorageException
+     */
+    public function getNode(string $key): Storage {
+        return $this->nodes[$this->getNodeName($this->prefix . $key)];
+    }
+
+    /**
+     * Return the name of the node that a fully prefixed key is mapped to. The first virtual node on the ring
+     * at or after the hash of the key is used, skipping nodes that have failed.
+     *
+     * @param string $key
+     * @return string
+     * @throws \Titon\Cache\Exception\MissingStorageException
+     */
+    public function getNodeName(string $key): string {
+        if (!$this->ring) {
+            $this->buildRing();
+        }
+
+        $points = $this->points;
+        $count = count($points);
+        $hash = crc32($key);
+        $low = 0;
+        $high = $count;
+
+        // Binary search for the first point at or after the hash
+        while ($low < $high) {
+            $mid = ($low + $high) >> 1;
+
+            if ($points[$mid] < $hash) {
+                $low = $mid + 1;
+            } else {
+                $high = $mid;
+            }
+        }
+
+        for ($i = 0; $i < $count; $i++) {
+            $name = $this->ring[$points[($low + $i) % $count]];
+
+            if ($this->isAvailable($name)) {
+                return $name;
+            }
+        }
+
+        throw new MissingStorageException('No cache nodes are available');
+    }
+
+    /**
+     * Return all nodes.
+     *
+     * @return \Titon\Cache\StorageMap
+     */
+    public function getNodes(): StorageMap {
+        return $this->nodes;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function has(string $key): bool {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            return $this->nodes[$name]->has($shardedKey);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->has($key);
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            return $this->nodes[$name]->increment($shardedKey, $step, $initial);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->increment($key, $step, $initial);
+        }
+    }
+
+    /**
+     * Return true if a node has not failed, or its retry interval has passed.
+     *
+     * @param string $name
+     * @return bool
+     */
+    public function isAvailable(string $name): bool {
+        $retryAt = $this->failed->get($name);
+
+        if ($retryAt === null) {
+            return $this->nodes->contains($name);
+        }
+
+        if ($retryAt <= time()) {
+            $this->failed->remove($name);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            return $this->nodes[$name]->lock($shardedKey, $ttl);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->lock($key, $ttl);
+        }
+    }
+
+    /**
+     * Mark a node as failed, which remaps its keys to other nodes until the retry interval has passed.
+     *
+     * @param string $name
+     * @return $this
+     */
+    public function markFailed(string $name): this {
+        $this->failed[$name] = time() + $this->retry;
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function remove(string $key): bool {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            return $this->nodes[$name]->remove($shardedKey);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->remove($key);
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        $removed = true;
+
+        foreach ($this->groupKeys($keys) as $name => $nodeKeys) {
+            try {
+                $removed = $this->nodes[$name]->removeMany($this->shardKeys($nodeKeys)) && $removed;
+            } catch (Exception $e) {
+                $this->handleFailure($name, $e);
+
+                $removed = $this->removeMany($nodeKeys) && $removed;
+            }
+        }
+
+        return $removed;
+    }
+
+    /**
+     * Remove a node from the ring. Its keys are remapped to the remaining nodes.
+     *
+     * @param string $name
+     * @return $this
+     */
+    public function removeNode(string $name): this {
+        $this->nodes->remove($name);
+        $this->weights->remove($name);
+        $this->failed->remove($name);
+        $this->ring = [];
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function set(string $key, mixed $value, int $expires): bool {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            return $this->nodes[$name]->set($shardedKey, $value, $expires);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->set($key, $value, $expires);
+        }
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $saved = true;
+
+        foreach ($this->groupKeys($values->keys()->toArray()) as $name => $nodeKeys) {
+            $nodeValues = Map {};
+
+            foreach ($nodeKeys as $key) {
+                $nodeValues[$this->prefix . $key] = $values[$key];
+            }
+
+            try {
+                $saved = $this->nodes[$name]->setMany($nodeValues, $expires) && $saved;
+            } catch (Exception $e) {
+                $this->handleFailure($name, $e);
+
+                $saved = $this->setMany($values->filterWithKey(($key, $value) ==> in_array($key, $nodeKeys, true)), $expires) && $saved;
+            }
+        }
+
+        return $saved;
+    }
+
+    /**
+     * Return the sum of the numeric statistics of each available node. The hit ratio is calculated from
+     * the summed hits and misses, and the uptime is the longest uptime of all nodes.
+     *
+     * {@inheritdoc}
+     */
+    public function stats(): StatsMap {
+        $totals = Map {};
+
+        foreach ($this->nodes as $name => $storage) {
+            if (!$this->isAvailable($name)) {
+                continue;
+            }
+
+            try {
+                $nodeStats = $storage->stats();
+            } catch (Exception $e) {
+                $this->handleFailure($name, $e);
+                continue;
+            }
+
+            foreach ($nodeStats as $stat => $value) {
+                if (!is_int($value) && !is_float($value)) {
+                    continue;
+                }
+
+                if ($stat === self::UPTIME) {
+                    $totals[$stat] = max($totals->get($stat) ?: 0, $value);
+
+                } else if ($stat !== self::HIT_RATIO) {
+                    $totals[$stat] = ($totals->get($stat) ?: 0) + $value;
+                }
+            }
+        }
+
+        if ($totals->contains(self::HITS) && $totals->contains(self::MISSES)) {
+            $lookups = $totals[self::HITS] + $totals[self::MISSES];
+
+            $totals[self::HIT_RATIO] = $lookups ? round($totals[self::HITS] / $lookups, 4) : 0.0;
+        }
+
+        $stats = Map {};
+
+        foreach ($totals as $stat => $total) {
+            $stats[$stat] = $total;
+        }
+
+        return $stats;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unlock(string $key): bool {
+        $shardedKey = $this->prefix . $key;
+        $name = $this->getNodeName($shardedKey);
+
+        try {
+            return $this->nodes[$name]->unlock($shardedKey);
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return $this->unlock($key);
+        }
+    }
+
+    /**
+     * Mark a node as failed if the exception it threw is a node error, like a connection error,
+     * otherwise rethrow the exception, as the item would fail on any node.
+     *
+     * @param string $name
+     * @param \Exception $e
+     * @throws \Exception
+     */
+    protected function handleFailure(string $name, Exception $e): void {
+        if ($this->isItemError($e)) {
+            throw $e;
+        }
+
+        $this->markFailed($name);
+    }
+
+    /**
+     * Return true if an exception was caused by the item itself, instead of the node.
+     *
+     * @param \Exception $e
+     * @return bool
+     */
+    protected function isItemError(Exception $e): bool {
+        return (
+            $e instanceof CorruptedItemException ||
+            $e instanceof InvalidItemException ||
+            $e instanceof MissingItemException ||
+            $e instanceof UnsupportedOperationException
+        );
+    }
+
+    /**
+     * Place each node on the ring once per virtual node.
+     */
+    protected function buildRing(): void {
+        $ring = [];
+
+        foreach ($this->weights as $name => $weight) {
+            for ($i = 0, $total = $this->replicas * $weight; $i < $total; $i++) {
+                $ring[crc32($name . '#' . $i)] = $name;
+            }
+        }
+
+        ksort($ring);
+
+        $this->ring = $ring;
+        $this->points = array_keys($ring);
+    }
+
+    /**
+     * Fetch items from a single node. If the node fails, the keys are remapped and fetched again.
+     *
+     * @param string $name
+     * @param array<string> $keys
+     * @return Awaitable<\Titon\Cache\ItemMap>
+     */
+    protected async function genGetNodeItems(string $name, array<string> $keys): Awaitable<ItemMap> {
+        try {
+            $found = await $this->nodes[$name]->genGetItems($this->shardKeys($keys));
+        } catch (Exception $e) {
+            $this->handleFailure($name, $e);
+
+            return await $this->genGetItems($keys);
+        }
+
+        $items = Map {};
+
+        foreach ($keys as $key) {
+            $item = $found->get($this->prefix . $key);
+
+            $items[$key] = ($item && $item->isHit()) ? new HitItem($key, $item->get()) : new MissItem($key);
+        }
+
+        return $items;
+    }
+
+    /**
+     * Group keys by the name of the node they are mapped to.
+     *
+     * @param array<string> $keys
+     * @return array<string, array<string>>
+     */
+    protected function groupKeys(array<string> $keys): array<string, array<string>> {
+        $groups = [];
+
+        foreach ($keys as $key) {
+            $groups[$this->getNodeName($this->prefix . $key)][] = $key;
+        }
+
+        return $groups;
+    }
+
+    /**
+     * Prepend the prefix of this storage to each key, before the keys are passed to the nodes.
+     *
+     * @param array<string> $keys
+     * @return array<string>
+     */
+    protected function shardKeys(array<string> $keys): array<string> {
+        return array_map($key ==> $this->prefix . $key, $keys);
+    }
+
+}
@@ -0,0 +1,222 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
+use Titon\Cache\StatsMap;
+use Titon\Cache\Storage;
+use Titon\Cache\ValueMap;
+
+/**
+ * A view of a storage engine where every key is namespaced by the current version of a set of tags.
+ * Invalidating a tag changes its version, which moves all the keys of the view to a new namespace,
+ * so that previously saved items are never read again and expire naturally.
+ *
+ * {{{
+ *        $storage->tagged(['user:1'])->save(new Item('profile', $profile));
+ *        $storage->invalidateTags(['user:1']);
+ * }}}
+ *
+ * @package Titon\Cache\Storage
+ */
+class TaggedStorage extends AbstractStorage {
+
+    /**
+     * The storage engine being namespaced.
+     *
+     * @var \Titon\Cache\Storage\AbstractStorage
+     */
+    protected AbstractStorage $storage;
+
+    /**
+     * Sorted list of unique tags.
+     *
+     * @var array<string>
+     */
+    protected array<string> $tags;
+
+    /**
+     * Set the storage engine and tags.
+     *
+     * @param \Titon\Cache\Storage\AbstractStorage $storage
+     * @param array<string> $tags
+     */
+    public function __construct(AbstractStorage $storage, array<string> $tags) {
+        $tags = array_values(array_unique($tags));
+        sort($tags);
+
+        $this->storage = $storage;
+        $this->tags = $tags;
+
+        parent::__construct();
+    }
+
+    /**
+     * Invalidate the tags of this view.
+     *
+     * {@inheritdoc}
+     */
+    public function flush(): bool {
+        return $this->invalidateTags($this->getTags());
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItem(string $key): Item {
+        $item = $this->getStorage()->getItem($this->getNamespace() . $key);
+
+        return $item->isHit() ? new HitItem($key, $item->get()) : new MissItem($key);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $namespace = $this->getNamespace();
+        $found = $this->getStorage()->getMany(array_map($key ==> $namespace . $key, $keys));
+        $values = Map {};
+
+        foreach ($keys as $key) {
+            if ($found->contains($namespace . $key)) {
+                $values[$key] = $found[$namespace . $key];
+            }
+        }
+
+        return $values;
+    }
+
+    /**
+     * Return the namespace that is prepended to every key, derived from the current tag versions.
+     *
+     * @return string
+     */
+    public function getNamespace(): string {
+        $versions = [];
+
+        foreach ($this->getTagVersions($this->getTags()) as $tag => $version) {
+            $versions[] = $tag . '=' . $version;
+        }
+
+        return substr(md5(implode('|', $versions)), 0, 16) . ':';
+    }
+
+    /**
+     * Return the storage engine being namespaced.
+     *
+     * @return \Titon\Cache\Storage\AbstractStorage
+     */
+    public function getStorage(): AbstractStorage {
+        return $this->storage;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getTags(): array<string> {
+        return $this->tags;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getTagVersions(array<string> $tags): Map<string, string> {
+        return $this->getStorage()->getTagVersions($tags);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function has(string $key): bool {
+        return $this->getStorage()->has($this->getNamespace() . $key);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        return $this->getStorage()->increment($this->getNamespace() . $key, $step, $initial);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function invalidateTags(array<string> $tags): bool {
+        return $this->getStorage()->invalidateTags($tags);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        return $this->getStorage()->lock($this->getNamespace() . $key, $ttl);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function remove(string $key): bool {
+        return $this->getStorage()->remove($this->getNamespace() . $key);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        $namespace = $this->getNamespace();
+
+        return $this->getStorage()->removeMany(array_map($key ==> $namespace . $key, $keys));
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function set(string $key, mixed $value, int $expires): bool {
+        return $this->getStorage()->set($this->getNamespace() . $key, $value, $expires);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $namespace = $this->getNamespace();
+        $namespaced = Map {};
+
+        foreach ($values as $key => $value) {
+            $namespaced[$namespace . $key] = $value;
+        }
+
+        return $this->getStorage()->setMany($namespaced, $expires);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function stats(): StatsMap {
+        return $this->getStorage()->stats();
+    }
+
+    /**
+     * Return a view that is namespaced by the tags of this view and the defined tags.
+     *
+     * {@inheritdoc}
+     */
+    public function tagged(array<string> $tags): Storage {
+        return $this->getStorage()->tagged(array_merge($this->getTags(), $tags));
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unlock(string $key): bool {
+        return $this->getStorage()->unlock($this->getNamespace() . $key);
+    }
+
+}
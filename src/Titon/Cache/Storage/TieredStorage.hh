@@ -0,0 +1,466 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\HitItem;
+use Titon\Cache\Item;
+use Titon\Cache\MissItem;
+use Titon\Cache\StatsMap;
+use Titon\Cache\Storage;
+use Titon\Cache\ValueMap;
+
+/**
+ * A storage engine that layers a small in-process L1 storage over a shared L2 storage.
+ * Reads are served from L1 when possible, and populate L1 from L2 on a miss (read-through).
+ * Writes and removals are sent to both tiers (write-through).
+ *
+ * Keys in L1 are scoped by a generation that is stored in L2 and replaced whenever items are removed or flushed,
+ * so that removals in one process invalidate the L1 of every other process, like a shared APC storage. The generation
+ * is read once per instance, which is once per request, so long running processes rely on the L1 TTL instead,
+ * which bounds how long they can serve a value that was changed in L2. Values that are overwritten in L2 by
+ * another process are also served from L1 until the L1 TTL passes.
+ *
+ * Misses can be cached in-process for a short duration, so that repeated lookups of missing keys do not hit L2.
+ * The number of remembered misses is bounded, and the oldest misses are forgotten first.
+ *
+ * {{{
+ *        new TieredStorage(new RedisStorage(new Redis()), new MemoryStorage('', 1000), 60, 5);
+ * }}}
+ *
+ * The prefix of this storage is prepended to keys before they are passed to each tier,
+ * which in turn apply their own prefix.
+ *
+ * @package Titon\Cache\Storage
+ */
+class TieredStorage extends AbstractStorage {
+
+    /**
+     * Key in L2 that holds the current generation.
+     */
+    const string GENERATION_KEY = 'tiered.generation';
+
+    /**
+     * Maximum number of misses to remember.
+     */
+    const int MAX_MISSES = 1000;
+
+    /**
+     * The generation that scopes keys in L1, or an empty string if it has not been loaded.
+     *
+     * @var string
+     */
+    protected string $generation = '';
+
+    /**
+     * The in-process storage.
+     *
+     * @var \Titon\Cache\Storage
+     */
+    protected Storage $l1;
+
+    /**
+     * Maximum number of seconds to keep an item in L1.
+     *
+     * @var int
+     */
+    protected int $l1Ttl;
+
+    /**
+     * The shared storage.
+     *
+     * @var \Titon\Cache\Storage
+     */
+    protected Storage $l2;
+
+    /**
+     * Expiration timestamps of keys that were missing from L2, ordered from oldest to newest.
+     *
+     * @var Map<string, int>
+     */
+    protected Map<string, int> $misses = Map {};
+
+    /**
+     * Number of seconds to remember a miss, or 0 to disable negative caching.
+     *
+     * @var int
+     */
+    protected int $missTtl;
+
+    /**
+     * Set the tiers and TTLs. If no L1 is defined, a bounded memory storage will be used.
+     *
+     * @param \Titon\Cache\Storage $l2
+     * @param \Titon\Cache\Storage $l1
+     * @param int $l1Ttl
+     * @param int $missTtl
+     * @param string $prefix
+     */
+    public function __construct(Storage $l2, ?Storage $l1 = null, int $l1Ttl = 60, int $missTtl = 0, string $prefix = '') {
+        $this->l2 = $l2;
+        $this->l1 = $l1 ?: new MemoryStorage('', 1000);
+        $this->l1Ttl = max(1, $l1Ttl);
+        $this->missTtl = max(0, $missTtl);
+
+        parent::__construct($prefix);
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function flush(): bool {
+        $this->misses->clear();
+
+        $flushed = ($this->l1->flush() && $this->l2->flush());
+
+        $this->invalidateGeneration();
+
+        return $flushed;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getItem(string $key): Item {
+        $tieredKey = $this->prefix . $key;
+        $item = $this->l1->getItem($this->l1Key($tieredKey));
+
+        if ($item->isHit()) {
+            return new HitItem($key, $item->get());
+        }
+
+        if ($this->isKnownMiss($tieredKey)) {
+            return new MissItem($key);
+        }
+
+        $item = $this->l2->getItem($tieredKey);
+
+        if (!$item->isHit()) {
+            $this->rememberMiss($tieredKey);
+
+            return new MissItem($key);
+        }
+
+        $this->l1->set($this->l1Key($tieredKey), $item->get(), time() + $this->l1Ttl);
+
+        return new HitItem($key, $item->get());
+    }
+
+    /**
+     * Return the current generation, which is loaded from L2 once, or created if L2 does not have one.
+     *
+     * @return string
+     */
+    public function getGeneration(): string {
+        if ($this->generation === '') {
+            $item = $this->l2->getItem($this->prefix . static::GENERATION_KEY);
+
+            if ($item->isHit()) {
+                $this->generation = (string) $item->get();
+            } else {
+                $this->invalidateGeneration();
+            }
+        }
+
+        return $this->generation;
+    }
+
+    /**
+     * Return the in-process storage.
+     *
+     * @return \Titon\Cache\Storage
+     */
+    public function getL1(): Storage {
+        return $this->l1;
+    }
+
+    /**
+     * Return the shared storage.
+     *
+     * @return \Titon\Cache\Storage
+     */
+    public function getL2(): Storage {
+        return $this->l2;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function getMany(array<string> $keys): ValueMap {
+        $values = Map {};
+        $found = $this->l1->getMany(array_map($key ==> $this->l1Key($key), $this->tierKeys($keys)));
+        $missing = [];
+
+        foreach ($keys as $key) {
+            $tieredKey = $this->prefix . $key;
+            $l1Key = $this->l1Key($tieredKey);
+
+            if ($found->contains($l1Key)) {
+                $values[$key] = $found[$l1Key];
+
+            } else if (!$this->isKnownMiss($tieredKey)) {
+                $missing[] = $key;
+            }
+        }
+
+        if (!$missing) {
+            return $values;
+        }
+
+        $found = $this->l2->getMany($this->tierKeys($missing));
+
+        foreach ($missing as $key) {
+            $tieredKey = $this->prefix . $key;
+
+            if ($found->contains($tieredKey)) {
+                $values[$key] = $found[$tieredKey];
+            } else {
+                $this->rememberMiss($tieredKey);
+            }
+        }
+
+        if ($found) {
+            $this->l1->setMany($this->l1Values($found), time() + $this->l1Ttl);
+        }
+
+        return $values;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function has(string $key): bool {
+        $tieredKey = $this->prefix . $key;
+
+        if ($this->l1->has($this->l1Key($tieredKey))) {
+            return true;
+        }
+
+        return (!$this->isKnownMiss($tieredKey) && $this->l2->has($tieredKey));
+    }
+
+    /**
+     * Counters are updated atomically in the shared storage.
+     *
+     * {@inheritdoc}
+     */
+    public function increment(string $key, int $step = 1, int $initial = 0): int {
+        $tieredKey = $this->prefix . $key;
+        $value = $this->l2->increment($tieredKey, $step, $initial);
+
+        $this->misses->remove($tieredKey);
+        $this->l1->set($this->l1Key($tieredKey), $value, time() + $this->l1Ttl);
+
+        return $value;
+    }
+
+    /**
+     * Locks are acquired from the shared storage.
+     *
+     * {@inheritdoc}
+     */
+    public function lock(string $key, int $ttl): bool {
+        return $this->l2->lock($this->prefix . $key, $ttl);
+    }
+
+    /**
+     * Removing an item invalidates the generation, and with it every item in L1, of all processes.
+     *
+     * {@inheritdoc}
+     */
+    public function remove(string $key): bool {
+        $tieredKey = $this->prefix . $key;
+
+        $this->misses->remove($tieredKey);
+        $this->l1->remove($this->l1Key($tieredKey));
+
+        $removed = $this->l2->remove($tieredKey);
+
+        $this->invalidateGeneration();
+
+        return $removed;
+    }
+
+    /**
+     * Removing items invalidates the generation, and with it every item in L1, of all processes.
+     *
+     * {@inheritdoc}
+     */
+    public function removeMany(array<string> $keys): bool {
+        $tieredKeys = $this->tierKeys($keys);
+
+        foreach ($tieredKeys as $tieredKey) {
+            $this->misses->remove($tieredKey);
+        }
+
+        $this->l1->removeMany(array_map($key ==> $this->l1Key($key), $tieredKeys));
+
+        $removed = $this->l2->removeMany($tieredKeys);
+
+        $this->invalidateGeneration();
+
+        return $removed;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function set(string $key, mixed $value, int $expires): bool {
+        $tieredKey = $this->prefix . $key;
+
+        $this->misses->remove($tieredKey);
+
+        if (!$this->l2->set($tieredKey, $value, $expires)) {
+            $this->l1->remove($this->l1Key($tieredKey));
+
+            return false;
+        }
+
+        $this->l1->set($this->l1Key($tieredKey), $value, $this->getL1Expiration($expires));
+
+        return true;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function setMany(ValueMap $values, int $expires): bool {
+        $tieredValues = Map {};
+
+        foreach ($values as $key => $value) {
+            $tieredKey = $this->prefix . $key;
+            $tieredValues[$tieredKey] = $value;
+
+            $this->misses->remove($tieredKey);
+        }
+
+        if (!$this->l2->setMany($tieredValues, $expires)) {
+            $this->l1->removeMany(array_map($key ==> $this->l1Key($key), $tieredValues->keys()->toArray()));
+
+            return false;
+        }
+
+        $this->l1->setMany($this->l1Values($tieredValues), $this->getL1Expiration($expires));
+
+        return true;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function stats(): StatsMap {
+        return $this->l2->stats();
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function unlock(string $key): bool {
+        return $this->l2->unlock($this->prefix . $key);
+    }
+
+    /**
+     * Return the expiration to use for L1, which is capped by the L1 TTL.
+     * Items that never expire in L2 are still kept in L1 for at most the L1 TTL.
+     *
+     * @param int $expires
+     * @return int
+     */
+    protected function getL1Expiration(int $expires): int {
+        $ttl = time() + $this->l1Ttl;
+
+        return ($expires > 0) ? min($expires, $ttl) : $ttl;
+    }
+
+    /**
+     * Replace the generation in L2 with a new one, so that every process stops reading the items in its L1.
+     */
+    protected function invalidateGeneration(): void {
+        $this->generation = $this->generateTagVersion();
+
+        $this->l2->set($this->prefix . static::GENERATION_KEY, $this->generation, time() + self::TAG_TTL);
+    }
+
+    /**
+     * Return true if the key was recently missing from L2.
+     *
+     * @param string $key
+     * @return bool
+     */
+    protected function isKnownMiss(string $key): bool {
+        $expires = $this->misses->get($key);
+
+        if ($expires === null) {
+            return false;
+        }
+
+        if ($expires < time()) {
+            $this->misses->remove($key);
+
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Scope a tiered key to the current generation, before it is passed to L1.
+     *
+     * @param string $key
+     * @return string
+     */
+    protected function l1Key(string $key): string {
+        return $this->getGeneration() . ':' . $key;
+    }
+
+    /**
+     * Scope the tiered keys of a value map to the current generation, before it is passed to L1.
+     *
+     * @param \Titon\Cache\ValueMap $values
+     * @return \Titon\Cache\ValueMap
+     */
+    protected function l1Values(ValueMap $values): ValueMap {
+        $l1Values = Map {};
+
+        foreach ($values as $key => $value) {
+            $l1Values[$this->l1Key($key)] = $value;
+        }
+
+        return $l1Values;
+    }
+
+    /**
+     * Remember that a key is missing from L2, if negative caching is enabled.
+     * If too many misses are remembered, the oldest are forgotten.
+     *
+     * @param string $key
+     */
+    protected function rememberMiss(string $key): void {
+        if (!$this->missTtl) {
+            return;
+        }
+
+        // Move to the end of the list
+        $this->misses->remove($key);
+        $this->misses[$key] = time() + $this->missTtl;
+
+        while ($this->misses->count() > static::MAX_MISSES) {
+            $this->misses->remove($this->misses->firstKey());
+        }
+    }
+
+    /**
+     * Prepend the prefix of this storage to each key, before the keys are passed to the tiers.
+     *
+     * @param array<string> $keys
+     * @return array<string>
+     */
+    protected function tierKeys(array<string> $keys): array<string> {
+        return array_map($key ==> $this->prefix . $key, $keys);
+    }
+
+}
@@ -18,5 +18,12 @@ namespace Titon\Cache {
     type ItemList = Vector<Item>;
     type ItemMap = Map<string, Item>;
     type StatsMap = Map<string, mixed>;
+    type StoreMeta = shape('delta' => float, 'expires' => int);
     type StorageMap = Map<string, Storage>;
+    type ValueMap = Map<string, mixed>;
+}
+
+namespace Titon\Cache\Storage {
+    type MemoryEntry = shape('expires' => int, 'size' => int);
+    type MemoryEntryMap = Map<string, MemoryEntry>;
 }
@@ -18,6 +18,14 @@ class Emitter {
     const int AUTO_PRIORITY = 0;
     const int DEFAULT_PRIORITY = 100;
 
+    /**
+     * Observers per event sorted by priority, and partitioned into synchronous and asynchronous observers.
+     * Is built on the first emit and cleared when the observers of the event change.
+     *
+     * @var Map<string, \Titon\Event\CompiledObservers>
+     */
+    protected Map<string, CompiledObservers> $compiled = Map {};
+
     /**
      * Registered observers per event.
      *
@@ -32,28 +40,19 @@ class Emitter {
      * @return \Titon\Event\Event
      */
     public function emit(Event $event): Event {
-        $key = $event->getKey();
+        $compiled = $this->getCompiledObservers($event->getKey());
+        $sorted = $compiled['sorted'];
 
-        // Set call stack
-        $event->setCallStack($this->getCallStack($key));
+        // Set call stack, which is only built if requested
+        $event->setCallStackLoader(() ==> $this->buildCallStack($sorted));
 
-        // Group the observers
-        $observers = $this->getSortedObservers($key);
-        $syncObservers = Vector {};
-        $asyncObservers = Vector {};
+        // Notify observers
+        $this->notifyObservers($compiled['sync'], $event);
 
-        foreach ($observers as $observer) {
-            if ($observer->isAsync()) {
-                $asyncObservers[] = $observer;
-            } else {
-                $syncObservers[] = $observer;
-            }
+        if ($compiled['async']) {
+            $this->notifyObserversAsync($compiled['async'], $event)->getWaitHandle()->join();
         }
 
-        // Notify observers
-        $this->notifyObservers($syncObservers, $event);
-        $this->notifyObserversAsync($asyncObservers, $event)->getWaitHandle()->join();
-
         return $event;
     }
 
@@ -82,8 +81,10 @@ class Emitter {
     public function flush(string $event = ''): this {
         if (!$event) {
             $this->observers->clear();
+            $this->compiled->clear();
         } else {
             $this->observers->remove($event);
+            $this->compiled->remove($event);
         }
 
         return $this;
@@ -96,13 +97,7 @@ class Emitter {
      * @return \Titon\Event\CallStackList
      */
     public function getCallStack(string $event): CallStackList {
-        $stack = Vector {};
-
-        foreach ($this->getSortedObservers($event) as $observer) {
-            $stack[] = $observer->getCaller();
-        }
-
-        return $stack;
+        return $this->buildCallStack($this->getCompiledObservers($event)['sorted']);
     }
 
     /**
@@ -135,19 +130,7 @@ class Emitter {
      * @return \Titon\Event\ObserverList
      */
     public function getSortedObservers(string $event): ObserverList {
-        $observers = $this->getObservers($event);
-
-        if ($observers) {
-            usort($observers, ($a, $b) ==> {
-                if ($a->getPriority() == $b->getPriority()) {
-                    return 0;
-                }
-
-                return ($a->getPriority() < $b->getPriority()) ? -1 : 1;
-            });
-        }
-
-        return $observers;
+        return $this->getCompiledObservers($event)['sorted']->toVector();
     }
 
     /**
@@ -198,6 +181,7 @@ class Emitter {
         }
 
         $this->observers[$event][] = new Observer($callback, $priority, $once);
+        $this->compiled->remove($event);
 
         return $this;
     }
@@ -236,14 +220,28 @@ class Emitter {
             }
         }
 
-        // We must do this as you can't remove keys while iterating
-        foreach ($indices as $i) {
+        // We must do this as you can't remove keys while iterating, and in reverse as keys shift after removal
+        foreach (array_reverse($indices->toArray()) as $i) {
             $this->observers[$event]->removeKey($i);
         }
 
+        if ($indices) {
+            $this->compiled->remove($event);
+        }
+
         return $this;
     }
 
+    /**
+     * Return the callers of a list of observers.
+     *
+     * @param \Titon\Event\ObserverList $observers
+     * @return \Titon\Event\CallStackList
+     */
+    protected function buildCallStack(ObserverList $observers): CallStackList {
+        return $observers->map($observer ==> $observer->getCaller());
+    }
+
     /**
      * Notify the observer by executing the callback with the defined params.
      * Can optionally stop the event and set a state based on the callbacks response.
@@ -283,6 +281,52 @@ class Emitter {
         return $this->handleExecution($event, $response);
     }
 
+    /**
+     * Return the observers for an event sorted by priority, and partitioned into synchronous and asynchronous
+     * observers. Observers with the same priority keep their subscription order. The result is cached until
+     * the observers change.
+     *
+     * @param string $event
+     * @return \Titon\Event\CompiledObservers
+     */
+    protected function getCompiledObservers(string $event): CompiledObservers {
+        if ($this->compiled->contains($event)) {
+            return $this->compiled[$event];
+        }
+
+        $order = Map {};
+        $sorted = Vector {};
+        $sync = Vector {};
+        $async = Vector {};
+
+        foreach ($this->getObservers($event) as $i => $observer) {
+            $order[spl_object_hash($observer)] = $i;
+            $sorted[] = $observer;
+        }
+
+        usort($sorted, ($a, $b) ==> {
+            if ($a->getPriority() == $b->getPriority()) {
+                return $order[spl_object_hash($a)] - $order[spl_object_hash($b)];
+            }
+
+            return ($a->getPriority() < $b->getPriority()) ? -1 : 1;
+        });
+
+        foreach ($sorted as $observer) {
+            if ($observer->isAsync()) {
+                $async[] = $observer;
+            } else {
+                $sync[] = $observer;
+            }
+        }
+
+        return $this->compiled[$event] = shape(
+            'sorted' => $sorted,
+            'sync' => $sync,
+            'async' => $async
+        );
+    }
+
     /**
      * Handle the response of an executed observer callback.
      * If the response is null, void (no return from callback), or true, don't do anything.
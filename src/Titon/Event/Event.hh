@@ -44,11 +44,18 @@ class Event {
     protected bool $stopped = false;
 
     /**
-     * The call stack in order of priority.
+     * The call stack in order of priority. Is built from the loader on first access.
      *
      * @var \Titon\Event\CallStackList
      */
-    protected CallStackList $stack = Vector {};
+    protected ?CallStackList $stack;
+
+    /**
+     * Callback that builds the call stack.
+     *
+     * @var \Titon\Event\CallStackLoader
+     */
+    protected ?CallStackLoader $stackLoader;
 
     /**
      * The last state before the object was stopped.
@@ -81,6 +88,11 @@ class Event {
      * @return \Titon\Event\CallStackList
      */
     public function getCallStack(): CallStackList {
+        if ($this->stack === null) {
+            $loader = $this->stackLoader;
+            $this->stack = $loader ? $loader() : Vector {};
+        }
+
         return $this->stack;
     }
 
@@ -160,6 +172,20 @@ class Event {
      */
     public function setCallStack(CallStackList $stack): this {
         $this->stack = $stack;
+        $this->stackLoader = null;
+
+        return $this;
+    }
+
+    /**
+     * Set a callback that builds the call stack, so that the call stack is only built if it is requested.
+     *
+     * @param \Titon\Event\CallStackLoader $loader
+     * @return $this
+     */
+    public function setCallStackLoader(CallStackLoader $loader): this {
+        $this->stack = null;
+        $this->stackLoader = $loader;
 
         return $this;
     }
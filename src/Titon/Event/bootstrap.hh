@@ -15,6 +15,8 @@
 
 namespace Titon\Event {
     type CallStackList = Vector<string>;
+    type CallStackLoader = (function(): CallStackList);
+    type CompiledObservers = shape('sorted' => ObserverList, 'sync' => ObserverList, 'async' => ObserverList);
     type DataMap = Map<string, mixed>;
     type EventList = Vector<Event>;
     type EventMap = Map<string, Event>;
@@ -8,6 +8,7 @@
 namespace Titon\Route;
 
 use Titon\Route\Exception\NoMatchException;
+use Titon\Route\Exception\UnexportableRouteException;
 use ReflectionFunction;
 
 /**
@@ -50,6 +51,16 @@ class CallbackRoute extends Route {
         return $callback->invokeArgs($this->getArguments($callback));
     }
 
+    /**
+     * Callbacks cannot be written to a static file, so callback routes cannot be exported.
+     *
+     * @return \Titon\Route\RouteExport
+     * @throws \Titon\Route\Exception\UnexportableRouteException
+     */
+    public function export(): RouteExport {
+        throw new UnexportableRouteException(sprintf('Callback route %s cannot be exported', $this->getPath()));
+    }
+
     /**
      * Return the callback function.
      *
@@ -0,0 +1,25 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * An indexed matcher builds an index from the routes it is given, and re-uses it across matches.
+ * The index must be reset whenever the mapped routes change.
+ *
+ * @package Titon\Route
+ */
+interface IndexedMatcher extends Matcher {
+
+    /**
+     * Empty the index so that it is rebuilt during the next match.
+     *
+     * @return $this
+     */
+    public function reset(): this;
+
+}
\ No newline at end of file
@@ -33,4 +33,13 @@ class LocaleRoute extends Route {
         return parent::compile();
     }
 
+    /**
+     * The locale token is prepended during compilation, so the path is never literal.
+     *
+     * @return bool
+     */
+    public function isLiteral(): bool {
+        return false;
+    }
+
 }
@@ -0,0 +1,157 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * A bounded least-recently-used cache of match results, which maps a request signature
+ * to the key of the matched route and the params that were extracted from the URL.
+ * Hit and miss counters are tracked to determine the effectiveness of the cache.
+ *
+ * @package Titon\Route
+ */
+class MatchCache {
+
+    /**
+     * Number of lookups that returned a result.
+     *
+     * @var int
+     */
+    protected int $hits = 0;
+
+    /**
+     * Maximum number of results to store.
+     *
+     * @var int
+     */
+    protected int $limit;
+
+    /**
+     * Number of lookups that did not return a result.
+     *
+     * @var int
+     */
+    protected int $misses = 0;
+
+    /**
+     * Cached results, ordered from least to most recently used.
+     *
+     * @var \Titon\Route\MatchResultMap
+     */
+    protected MatchResultMap $results = Map {};
+
+    /**
+     * Set the maximum number of results.
+     *
+     * @param int $limit
+     */
+    public function __construct(int $limit = 1000) {
+        $this->limit = max(1, $limit);
+    }
+
+    /**
+     * Remove all cached results. The counters are not reset.
+     *
+     * @return $this
+     */
+    public function flush(): this {
+        $this->results->clear();
+
+        return $this;
+    }
+
+    /**
+     * Return a cached result and mark it as the most recently used, or return null if it does not exist.
+     *
+     * @param string $key
+     * @return \Titon\Route\MatchResult
+     */
+    public function get(string $key): ?MatchResult {
+        $result = $this->results->get($key);
+
+        if ($result === null) {
+            $this->misses++;
+
+            return null;
+        }
+
+        $this->hits++;
+
+        // Move to the end of the list
+        $this->results->remove($key);
+        $this->results[$key] = $result;
+
+        return $result;
+    }
+
+    /**
+     * Return the ratio of lookups that returned a result, between 0 and 1.
+     *
+     * @return float
+     */
+    public function getHitRatio(): float {
+        $total = $this->hits + $this->misses;
+
+        return $total ? ($this->hits / $total) : 0.0;
+    }
+
+    /**
+     * Return the number of hits.
+     *
+     * @return int
+     */
+    public function getHits(): int {
+        return $this->hits;
+    }
+
+    /**
+     * Return the maximum number of results.
+     *
+     * @return int
+     */
+    public function getLimit(): int {
+        return $this->limit;
+    }
+
+    /**
+     * Return the number of misses.
+     *
+     * @return int
+     */
+    public function getMisses(): int {
+        return $this->misses;
+    }
+
+    /**
+     * Return all cached results.
+     *
+     * @return \Titon\Route\MatchResultMap
+     */
+    public function getResults(): MatchResultMap {
+        return $this->results;
+    }
+
+    /**
+     * Store a result, and evict the least recently used result if the limit has been reached.
+     *
+     * @param string $key
+     * @param \Titon\Route\MatchResult $result
+     * @return $this
+     */
+    public function set(string $key, MatchResult $result): this {
+        $this->results->remove($key);
+
+        if ($this->results->count() >= $this->limit) {
+            $this->results->remove($this->results->firstKey());
+        }
+
+        $this->results[$key] = $result;
+
+        return $this;
+    }
+
+}
@@ -0,0 +1,327 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\IndexedMatcher;
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+
+/**
+ * Combines the compiled regex of multiple routes into chunked alternation patterns, so that a single
+ * `preg_match()` call can determine the first matching route in a chunk, and extract its captures.
+ *
+ * Each alternative is wrapped in a branch reset group, padded with empty groups, and terminated by an empty
+ * marker group. The marker always participates in a match, even when trailing optional tokens do not,
+ * so the number of returned groups identifies the route that matched.
+ *
+ * @package Titon\Route\Matcher
+ */
+class CombinedMatcher implements IndexedMatcher {
+
+    /**
+     * Number of routes to combine into a single regex.
+     *
+     * @var int
+     */
+    protected int $chunkSize;
+
+    /**
+     * Combined regex patterns keyed by their route range.
+     *
+     * @var Map<string, \Titon\Route\Matcher\CombinedChunk>
+     */
+    protected Map<string, CombinedChunk> $chunks = Map {};
+
+    /**
+     * Number of routes that were indexed.
+     *
+     * @var int
+     */
+    protected int $count = 0;
+
+    /**
+     * Number of capture groups within each route's compiled regex.
+     *
+     * @var Vector<int>
+     */
+    protected Vector<int> $groups = Vector {};
+
+    /**
+     * The route map the chunks were built from.
+     *
+     * @var \Titon\Route\RouteMap
+     */
+    protected ?RouteMap $indexed;
+
+    /**
+     * Route indices grouped by their literal path, for replicating the direct path comparison in `Route::isMatch()`.
+     *
+     * @var Map<string, Vector<int>>
+     */
+    protected Map<string, Vector<int>> $paths = Map {};
+
+    /**
+     * List of indexed routes in mapping order.
+     *
+     * @var Vector<\Titon\Route\Route>
+     */
+    protected Vector<Route> $routes = Vector {};
+
+    /**
+     * Set the chunk size.
+     *
+     * @param int $chunkSize
+     */
+    public function __construct(int $chunkSize = 10) {
+        $this->chunkSize = max(1, $chunkSize);
+    }
+
+    /**
+     * Index the routes that will be combined. Routes will be compiled during this process.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return $this
+     */
+    public function build(RouteMap $routes): this {
+        $this->reset();
+
+        $index = 0;
+
+        foreach ($routes as $route) {
+            $path = $route->getPath();
+
+            $this->routes[] = $route;
+            $this->groups[] = $this->countGroups($route->compile());
+
+            if (!$this->paths->contains($path)) {
+                $this->paths[$path] = Vector {};
+            }
+
+            $indices = $this->paths[$path];
+            $indices[] = $index;
+
+            $index++;
+        }
+
+        $this->indexed = $routes;
+        $this->count = $routes->count();
+
+        return $this;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function match(string $url, RouteMap $routes): ?Route {
+        if ($routes !== $this->indexed || $routes->count() !== $this->count) {
+            $this->build($routes);
+        }
+
+        $start = 0;
+        $total = $this->routes->count();
+
+        // Find the next route that matches the URL, and if it cannot respond to the
+        // current request, continue searching from the route that follows it
+        while ($start < $total) {
+            $exact = $this->findPath($url, $start);
+            $found = null;
+            $chunkStart = $start;
+
+            while ($chunkStart < $total) {
+                $chunkEnd = min($total, ((int) ($chunkStart / $this->chunkSize) + 1) * $this->chunkSize);
+
+                if ($exact !== null && $exact < $chunkStart) {
+                    break;
+                }
+
+                $found = $this->matchChunk($url, $chunkStart, $chunkEnd);
+
+                if ($found !== null) {
+                    break;
+                }
+
+                $chunkStart = $chunkEnd;
+            }
+
+            if ($exact !== null && ($found === null || $exact <= $found['index'])) {
+                $found = shape('index' => $exact, 'captures' => [$url]);
+            }
+
+            if ($found === null) {
+                return null;
+            }
+
+            $route = $this->routes[$found['index']];
+
+            if ($route->isMethod() && $route->isSecure() && $route->isValid()) {
+                $route->match($found['captures']);
+
+                return $route;
+            }
+
+            $start = $found['index'] + 1;
+        }
+
+        return null;
+    }
+
+    /**
+     * Empty the chunks so that they are rebuilt during the next match.
+     *
+     * @return $this
+     */
+    public function reset(): this {
+        $this->count = 0;
+        $this->indexed = null;
+        $this->chunks = Map {};
+        $this->groups = Vector {};
+        $this->paths = Map {};
+        $this->routes = Vector {};
+
+        return $this;
+    }
+
+    /**
+     * Count the number of capturing groups within a regex pattern.
+     *
+     * @param string $regex
+     * @return int
+     */
+    protected function countGroups(string $regex): int {
+        $length = strlen($regex);
+        $count = 0;
+        $class = false;
+
+        for ($i = 0; $i < $length; $i++) {
+            $char = $regex[$i];
+
+            if ($char === '\\') {
+                $i++;
+
+            } else if ($class) {
+                $class = ($char !== ']');
+
+            } else if ($char === '[') {
+                $class = true;
+
+                // A closing bracket at the start of a class is a literal
+                if (substr($regex, $i + 1, 1) === '^') {
+                    $i++;
+                }
+
+                if (substr($regex, $i + 1, 1) === ']') {
+                    $i++;
+                }
+
+            } else if ($char === '(') {
+                $next = substr($regex, $i + 1, 1);
+
+                if ($next !== '?' && $next !== '*') {
+                    $count++;
+
+                } else if (preg_match('/^\(\?(P?<[a-z_]|\')/i', substr($regex, $i, 5))) {
+                    $count++; // Named group
+                }
+            }
+        }
+
+        return $count;
+    }
+
+    /**
+     * Return the first route index, at or after the starting index, whose path is identical to the URL.
+     *
+     * @param string $url
+     * @param int $start
+     * @return int
+     */
+    protected function findPath(string $url, int $start): ?int {
+        $indices = $this->paths->get($url);
+
+        if ($indices !== null) {
+            foreach ($indices as $index) {
+                if ($index >= $start) {
+                    return $index;
+                }
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Return the combined regex for a range of routes, or build it if it does not exist.
+     *
+     * @param int $start
+     * @param int $end
+     * @return \Titon\Route\Matcher\CombinedChunk
+     */
+    protected function getChunk(int $start, int $end): CombinedChunk {
+        $key = $start . ':' . $end;
+
+        if ($this->chunks->contains($key)) {
+            return $this->chunks[$key];
+        }
+
+        $alternatives = [];
+        $routeMap = Map {};
+        $total = 0;
+
+        for ($i = $start; $i < $end; $i++) {
+            $groups = $this->groups[$i];
+            $total = max($total, $groups);
+
+            // Pad to the previous marker, then append the marker for this route
+            $alternatives[] = $this->routes[$i]->compile() . str_repeat('()', $total - $groups + 1);
+
+            $total++;
+            $routeMap[$total] = $i;
+        }
+
+        return $this->chunks[$key] = shape(
+            'regex' => '~^(?|' . implode('|', $alternatives) . ')$~i',
+            'routes' => $routeMap
+        );
+    }
+
+    /**
+     * Match the URL against a range of routes. Return the index of the first matching route,
+     * and the captures in the same format that `preg_match()` would return for the route alone.
+     *
+     * @param string $url
+     * @param int $start
+     * @param int $end
+     * @return \Titon\Route\Matcher\CombinedMatch
+     */
+    protected function matchChunk(string $url, int $start, int $end): ?CombinedMatch {
+        $chunk = $this->getChunk($start, $end);
+        $matches = [];
+
+        if (!preg_match($chunk['regex'], $url, $matches, PREG_OFFSET_CAPTURE)) {
+            return null;
+        }
+
+        $index = $chunk['routes'][count($matches) - 1];
+        $captures = [];
+
+        for ($i = 0; $i <= $this->groups[$index]; $i++) {
+            $captures[] = $matches[$i];
+        }
+
+        // Unmatched trailing groups are not returned by preg_match(), while the others are empty
+        while (count($captures) > 1 && $captures[count($captures) - 1][1] === -1) {
+            array_pop($captures);
+        }
+
+        return shape(
+            'index' => $index,
+            'captures' => array_map($capture ==> (string) $capture[0], $captures)
+        );
+    }
+
+}
@@ -0,0 +1,543 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route\Matcher;
+
+use Titon\Route\IndexedMatcher;
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+use \ReflectionMethod;
+
+/**
+ * Builds a segment trie from the mapped routes and resolves a URL by walking its path segments,
+ * instead of evaluating the regex of every route. Static segments are matched first, followed by typed tokens.
+ *
+ * Routes that cannot be represented in the trie (custom patterns, partial segment tokens, routes that rewrite
+ * their path during compilation, etc) fall back to regex matching, while still respecting the order in which
+ * routes were mapped.
+ *
+ * A trie is built once for every route map it is given, so that switching between the per-method route maps
+ * of the router does not cause a rebuild. Routes are only compiled once they are matched.
+ * The tries must be reset when routes are mapped, which the router does automatically.
+ *
+ * @package Titon\Route\Matcher
+ */
+class TrieMatcher implements IndexedMatcher {
+
+    /**
+     * Segment types that map to the tokens supported by `Route::compile()`.
+     */
+    const string LITERAL = '';
+    const string ALNUM = '{';
+    const string NUMERIC = '[';
+    const string WILDCARD = '(';
+
+    /**
+     * Characters permitted by the ALNUM and NUMERIC route patterns.
+     */
+    const string ALNUM_CHARS = 'abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-.';
+    const string NUMERIC_CHARS = '0123456789.';
+
+    /**
+     * Characters that cause a segment to be treated as a regex instead of a literal.
+     */
+    const string REGEX_CHARS = '\\^$|?*+()[]{}<>~';
+
+    /**
+     * Maximum number of optional tokens a route can have before it falls back to regex matching.
+     * Each optional token doubles the number of paths inserted into the trie.
+     */
+    const int MAX_OPTIONALS = 4;
+
+    /**
+     * The node ID of the trie root.
+     */
+    const int ROOT = 0;
+
+    /**
+     * Route indices, in mapping order, that must be matched with regex.
+     *
+     * @var Vector<int>
+     */
+    protected Vector<int> $fallback = Vector {};
+
+    /**
+     * The route map the current trie was built from.
+     *
+     * @var \Titon\Route\RouteMap
+     */
+    protected ?RouteMap $indexed;
+
+    /**
+     * Whether a route class overrides compilation, keyed by class name.
+     *
+     * @var Map<string, bool>
+     */
+    protected Map<string, bool> $rewrites = Map {};
+
+    /**
+     * Routes that terminate at each node.
+     *
+     * @var Vector<Vector<\Titon\Route\Matcher\TrieLeaf>>
+     */
+    protected Vector<Vector<TrieLeaf>> $leaves = Vector {};
+
+    /**
+     * List of indexed routes in mapping order.
+     *
+     * @var Vector<\Titon\Route\Route>
+     */
+    protected Vector<Route> $routes = Vector {};
+
+    /**
+     * Child nodes for static segments, keyed by lowercased segment.
+     *
+     * @var Vector<Map<string, int>>
+     */
+    protected Vector<Map<string, int>> $statics = Vector {};
+
+    /**
+     * Child nodes for token segments, keyed by segment type.
+     *
+     * @var Vector<Map<string, int>>
+     */
+    protected Vector<Map<string, int>> $tokens = Vector {};
+
+    /**
+     * Tries that have been built, keyed by the object hash of their route map.
+     * The route map is kept within the index, so that its hash cannot be re-used.
+     *
+     * @var Map<string, \Titon\Route\Matcher\TrieIndex>
+     */
+    protected Map<string, TrieIndex> $tries = Map {};
+
+    /**
+     * Build the trie from a map of routes, and make it the current trie.
+     * Routes are not compiled during this process, as the trie is built from their paths.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return $this
+     */
+    public function build(RouteMap $routes): this {
+        $this->clear();
+
+        $index = 0;
+
+        foreach ($routes as $route) {
+            $this->routes[] = $route;
+
+            $segments = $this->parsePath($route);
+
+            if ($segments === null || !$this->insert($index, $segments, ($route->getPath() === '/'))) {
+                $this->fallback[] = $index;
+            }
+
+            $index++;
+        }
+
+        $this->indexed = $routes;
+
+        $this->tries[spl_object_hash($routes)] = shape(
+            'map' => $routes,
+            'routes' => $this->routes,
+            'fallback' => $this->fallback,
+            'statics' => $this->statics,
+            'tokens' => $this->tokens,
+            'leaves' => $this->leaves
+        );
+
+        return $this;
+    }
+
+    /**
+     * Return the route indices that are matched with regex.
+     *
+     * @return Vector<int>
+     */
+    public function getFallback(): Vector<int> {
+        return $this->fallback;
+    }
+
+    /**
+     * {@inheritdoc}
+     */
+    public function match(string $url, RouteMap $routes): ?Route {
+        if ($routes !== $this->indexed) {
+            $this->load($routes);
+        }
+
+        $candidates = Vector {};
+        $segments = $this->parseUrl($url);
+
+        if ($segments !== null) {
+            $this->walk(self::ROOT, $segments, 0, [], ($url === ''), $candidates);
+        }
+
+        $list = $candidates->toArray();
+
+        // Order by mapping order, then by the regex preference of optional tokens
+        usort($list, ($a, $b) ==> ($a['index'] - $b['index']) ?: ($a['order'] - $b['order']));
+
+        // Interleave the regex routes so that mapping order is respected
+        $fallback = $this->fallback;
+        $total = $fallback->count();
+        $i = 0;
+
+        foreach ($list as $candidate) {
+            while ($i < $total && $fallback[$i] < $candidate['index']) {
+                $route = $this->routes[$fallback[$i++]];
+
+                if ($route->isMatch($url)) {
+                    return $route;
+                }
+            }
+
+            $route = $this->routes[$candidate['index']];
+
+            if ($route->isMethod() && $route->isSecure() && $route->isValid()) {
+                $route->compile(); // Tokens are required for mapping the captures
+                $route->match(array_merge([$url], $candidate['captures']));
+
+                return $route;
+            }
+        }
+
+        while ($i < $total) {
+            $route = $this->routes[$fallback[$i++]];
+
+            if ($route->isMatch($url)) {
+                return $route;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Empty all tries so that they are rebuilt during the next match.
+     *
+     * @return $this
+     */
+    public function reset(): this {
+        $this->tries->clear();
+
+        return $this->clear();
+    }
+
+    /**
+     * Create a new node and return its ID.
+     *
+     * @return int
+     */
+    protected function addNode(): int {
+        $this->statics[] = Map {};
+        $this->tokens[] = Map {};
+        $this->leaves[] = Vector {};
+
+        return $this->leaves->count() - 1;
+    }
+
+    /**
+     * Return the child node of a parent node for a segment, or create it if it does not exist.
+     *
+     * @param int $node
+     * @param \Titon\Route\Matcher\TrieSegment $segment
+     * @return int
+     */
+    protected function addChild(int $node, TrieSegment $segment): int {
+        $children = ($segment['type'] === self::LITERAL) ? $this->statics[$node] : $this->tokens[$node];
+        $key = ($segment['type'] === self::LITERAL) ? $segment['value'] : $segment['type'];
+        $child = $children->get($key);
+
+        if ($child === null) {
+            $child = $this->addNode();
+            $children[$key] = $child;
+        }
+
+        return $child;
+    }
+
+    /**
+     * Empty the current trie.
+     *
+     * @return $this
+     */
+    protected function clear(): this {
+        $this->indexed = null;
+        $this->fallback = Vector {};
+        $this->routes = Vector {};
+        $this->statics = Vector {};
+        $this->tokens = Vector {};
+        $this->leaves = Vector {};
+
+        $this->addNode();
+
+        return $this;
+    }
+
+    /**
+     * Insert a route into the trie. A route with optional tokens is inserted once for every combination
+     * of present and absent tokens, ordered in the same way the regex engine would backtrack.
+     * Return false if the route has too many optional tokens.
+     *
+     * @param int $index
+     * @param Vector<\Titon\Route\Matcher\TrieSegment> $segments
+     * @param bool $root
+     * @return bool
+     */
+    protected function insert(int $index, Vector<TrieSegment> $segments, bool $root): bool {
+        $optionals = $segments->filter($segment ==> $segment['optional'])->count();
+
+        if ($optionals > self::MAX_OPTIONALS) {
+            return false;
+        }
+
+        for ($order = 0; $order < (1 << $optionals); $order++) {
+            $node = self::ROOT;
+            $slots = [];
+            $bit = $optionals;
+
+            foreach ($segments as $segment) {
+                if ($segment['optional'] && ($order & (1 << --$bit))) {
+                    $slots[] = false;
+                    continue;
+                }
+
+                if ($segment['type'] !== self::LITERAL) {
+                    $slots[] = true;
+                }
+
+                $node = $this->addChild($node, $segment);
+            }
+
+            $leaves = $this->leaves[$node];
+            $leaves[] = shape(
+                'index' => $index,
+                'order' => $order,
+                'slots' => $slots,
+                'root' => $root
+            );
+        }
+
+        return true;
+    }
+
+    /**
+     * Validate a URL segment against the character set of a token type.
+     *
+     * @param string $type
+     * @param string $segment
+     * @return bool
+     */
+    protected function isTokenMatch(string $type, string $segment): bool {
+        $length = strlen($segment);
+
+        if ($length === 0) {
+            return false;
+        }
+
+        switch ($type) {
+            case self::ALNUM:
+                return (strspn($segment, self::ALNUM_CHARS) === $length);
+            case self::NUMERIC:
+                return (strspn($segment, self::NUMERIC_CHARS) === $length);
+        }
+
+        return true;
+    }
+
+    /**
+     * Make the trie for a route map the current trie, or build it if it does not exist.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return $this
+     */
+    protected function load(RouteMap $routes): this {
+        $trie = $this->tries->get(spl_object_hash($routes));
+
+        if ($trie === null) {
+            return $this->build($routes);
+        }
+
+        $this->indexed = $routes;
+        $this->routes = $trie['routes'];
+        $this->fallback = $trie['fallback'];
+        $this->statics = $trie['statics'];
+        $this->tokens = $trie['tokens'];
+        $this->leaves = $trie['leaves'];
+
+        return $this;
+    }
+
+    /**
+     * Return true if the class of a route overrides its compilation, like `LocaleRoute`, in which case
+     * the path cannot be trusted to represent the compiled regex.
+     *
+     * @param \Titon\Route\Route $route
+     * @return bool
+     */
+    protected function isRewritten(Route $route): bool {
+        $class = get_class($route);
+
+        if (!$this->rewrites->contains($class)) {
+            $rewritten = false;
+
+            foreach (['compile', 'compilePath'] as $method) {
+                if ((new ReflectionMethod($class, $method))->getDeclaringClass()->getName() !== Route::class) {
+                    $rewritten = true;
+                }
+            }
+
+            $this->rewrites[$class] = $rewritten;
+        }
+
+        return $this->rewrites[$class];
+    }
+
+    /**
+     * Break up a route path into trie segments.
+     * Return null if the path cannot be represented in the trie.
+     *
+     * @param \Titon\Route\Route $route
+     * @return Vector<\Titon\Route\Matcher\TrieSegment>
+     */
+    protected function parsePath(Route $route): ?Vector<TrieSegment> {
+        if ($this->isRewritten($route)) {
+            return null;
+        }
+
+        $path = $route->getPath();
+        $segments = Vector {};
+
+        if ($path === '/') {
+            return $segments;
+        }
+
+        if (substr($path, 0, 1) !== '/') {
+            return null;
+        }
+
+        $pairs = Map {self::ALNUM => '}', self::NUMERIC => ']', self::WILDCARD => ')'};
+
+        foreach (explode('/', substr($path, 1)) as $chunk) {
+            $matches = [];
+
+            if (!$route->isStatic() && preg_match('/^(\{|\[|\()([a-z0-9]+)(\?)?(\}|\]|\))$/i', $chunk, $matches)) {
+                if ($pairs[$matches[1]] !== $matches[4]) {
+                    return null;
+                }
+
+                $segments[] = shape(
+                    'type' => $matches[1],
+                    'value' => $matches[2],
+                    'optional' => ($matches[3] === '?')
+                );
+
+            } else if (strpbrk($chunk, self::REGEX_CHARS) === false) {
+                $segments[] = shape(
+                    'type' => self::LITERAL,
+                    'value' => strtolower($chunk),
+                    'optional' => false
+                );
+
+            } else {
+                return null;
+            }
+        }
+
+        return $segments;
+    }
+
+    /**
+     * Break up a URL into path segments while removing a single trailing slash.
+     * Return null if the URL can not match any route within the trie.
+     *
+     * @param string $url
+     * @return Vector<string>
+     */
+    protected function parseUrl(string $url): ?Vector<string> {
+        if ($url === '' || $url === '/') {
+            return Vector {};
+        }
+
+        if (substr($url, 0, 1) !== '/') {
+            return null;
+        }
+
+        $path = substr($url, 1);
+
+        if (substr($path, -1) === '/') {
+            $path = substr($path, 0, -1);
+
+            if ($path === '') {
+                return null;
+            }
+        }
+
+        return new Vector(explode('/', $path));
+    }
+
+    /**
+     * Recursively walk the trie, depth first, and collect the routes that terminate at the last segment.
+     *
+     * @param int $node
+     * @param Vector<string> $segments
+     * @param int $depth
+     * @param array<string> $captures
+     * @param bool $empty
+     * @param Vector<\Titon\Route\Matcher\TrieCandidate> $candidates
+     */
+    protected function walk(int $node, Vector<string> $segments, int $depth, array<string> $captures, bool $empty, Vector<TrieCandidate> $candidates): void {
+        if ($depth === $segments->count()) {
+            foreach ($this->leaves[$node] as $leaf) {
+
+                // The root path does not allow an empty URL, while absent optional tokens do
+                if ($leaf['root'] && $empty) {
+                    continue;
+                }
+
+                // Line up captures with their tokens, absent tokens become empty strings
+                $params = [];
+                $i = 0;
+
+                foreach ($leaf['slots'] as $present) {
+                    $params[] = $present ? $captures[$i++] : '';
+                }
+
+                // Trailing absent tokens are not returned by preg_match()
+                while ($params && $params[count($params) - 1] === '') {
+                    array_pop($params);
+                }
+
+                $candidates[] = shape(
+                    'index' => $leaf['index'],
+                    'order' => $leaf['order'],
+                    'captures' => $params
+                );
+            }
+
+            return;
+        }
+
+        $segment = $segments[$depth];
+        $child = $this->statics[$node]->get(strtolower($segment));
+
+        if ($child !== null) {
+            $this->walk($child, $segments, $depth + 1, $captures, $empty, $candidates);
+        }
+
+        foreach ($this->tokens[$node] as $type => $child) {
+            if ($this->isTokenMatch($type, $segment)) {
+                $next = $captures;
+                $next[] = $segment;
+
+                $this->walk($child, $segments, $depth + 1, $next, $empty, $candidates);
+            }
+        }
+    }
+
+}
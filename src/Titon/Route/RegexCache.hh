@@ -0,0 +1,101 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * The regex cache stores the result of compiling a route, keyed by the route class, path, and patterns.
+ * Compiled results are kept in memory for the current request, and in APC shared memory when it is available,
+ * so that subsequent requests within the same process can skip compilation entirely.
+ *
+ * @package Titon\Route
+ */
+class RegexCache {
+
+    /**
+     * Prefix for keys stored in APC.
+     */
+    const string PREFIX = 'titon.route.regex.';
+
+    /**
+     * Compiled results loaded during the current request.
+     *
+     * @var \Titon\Route\CompiledMap
+     */
+    protected static CompiledMap $compiled = Map {};
+
+    /**
+     * Remove all compiled results loaded during the current request. Results in shared memory are not removed,
+     * as their keys are derived from all the state that affects compilation, and can never become stale.
+     */
+    public static function flush(): void {
+        static::$compiled->clear();
+    }
+
+    /**
+     * Return the compiled result for a key, or null if it has not been compiled.
+     *
+     * @param string $key
+     * @return \Titon\Route\CompiledRoute
+     */
+    public static function get(string $key): ?CompiledRoute {
+        if (static::$compiled->contains($key)) {
+            return static::$compiled[$key];
+        }
+
+        if (static::isShared()) {
+            $success = false;
+            $data = apc_fetch(self::PREFIX . $key, $success);
+
+            if ($success) {
+                return static::$compiled[$key] = $data;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Return true if APC is available for sharing compiled results between requests.
+     *
+     * @return bool
+     */
+    <<__Memoize>>
+    public static function isShared(): bool {
+        return function_exists('apc_fetch');
+    }
+
+    /**
+     * Generate a cache key for a route based on the state that affects compilation.
+     *
+     * @param \Titon\Route\Route $route
+     * @return string
+     */
+    public static function key(Route $route): string {
+        return md5(implode('|', [
+            get_class($route),
+            $route->getPath(),
+            $route->getStatic() ? '1' : '0',
+            serialize($route->getPatterns()->toArray())
+        ]));
+    }
+
+    /**
+     * Store the compiled result for a key.
+     *
+     * @param string $key
+     * @param \Titon\Route\CompiledRoute $data
+     */
+    public static function set(string $key, CompiledRoute $data): void {
+        static::$compiled[$key] = $data;
+
+        if (static::isShared()) {
+            apc_store(self::PREFIX . $key, $data);
+        }
+    }
+
+}
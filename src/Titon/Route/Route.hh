@@ -7,6 +7,7 @@
 
 namespace Titon\Route;
 
+use Titon\Route\Exception\UnexportableRouteException;
 use Titon\Route\Exception\MissingPatternException;
 use Titon\Route\Exception\NoMatchException;
 use Titon\Route\Mixin\ConditionMixin;
@@ -16,6 +17,7 @@ use Titon\Route\Mixin\PatternMixin;
 use Titon\Route\Mixin\SecureMixin;
 use Titon\Utility\State\Server;
 use Titon\Utility\Registry;
+use \ReflectionClass;
 use \ReflectionFunctionAbstract;
 use \ReflectionMethod;
 use \Serializable;
@@ -123,82 +125,27 @@ class Route implements Serializable {
             return $this->compiled;
         }
 
-        $path = $this->getPath();
-        $compiled = str_replace(['/', '.'], ['\/', '\.'], $path);
-        $patterns = $this->getPatterns();
-
-        if (!$this->isStatic()) {
-            $tokens = [];
-            $matches = [];
-
-            // Match regex pattern tokens first
-            preg_match_all('/(\<)([^\<\>]+)(\>)/i', $path, $matches, PREG_SET_ORDER);
-            $tokens = array_merge($tokens, $matches);
-
-            // Then match regular tokens
-            preg_match_all('/(\{|\(|\[)([a-z0-9\?]+)(\}|\)|\])/i', $path, $matches, PREG_SET_ORDER);
-            $tokens = array_merge($tokens, $matches);
+        $key = RegexCache::key($this);
 
-            if ($tokens) {
-                foreach ($tokens as $match) {
-                    $chunk = $match[0];
-                    $open = array_key_exists(1, $match) ? $match[1] : ''; // opening brace
-                    $token = array_key_exists(2, $match) ? $match[2] : ''; // token
-                    $close = array_key_exists(3, $match) ? $match[3] : ''; // closing brace
-                    $optional = false;
+        // Use the result of a previous compilation of an identical route
+        if ($cached = RegexCache::get($key)) {
+            $this->tokens = new Vector($cached['tokens']);
+            $this->setPatterns(new Map($cached['patterns']));
+            $this->setStatic($cached['static']);
 
-                    // Is the token optional
-                    if (substr($token, -1) === '?') {
-                        $optional = true;
-                        $token = substr($token, 0, strlen($token) - 1);
-                    }
-
-                    // Pattern exists
-                    if (strpos($token, ':') !== false) {
-                        list($token, $pattern) = explode(':', $token, 2);
-
-                        $patterns[$token] = $pattern;
-                        $this->addPattern($token, $pattern);
-                    }
-
-                    if ($open === '{' && $close === '}') {
-                        $pattern = self::ALNUM;
-
-                    } else if ($open === '[' && $close === ']') {
-                        $pattern = self::NUMERIC;
-
-                    } else if ($open === '(' && $close === ')') {
-                        $pattern = self::WILDCARD;
-
-                    } else if ($open === '<' && $close === '>' && $patterns->contains($token)) {
-                        $pattern = '(' . trim($patterns[$token], '()') . ')';
-
-                    } else {
-                        throw new MissingPatternException(sprintf('Unknown pattern for %s token', $token));
-                    }
-
-                    // Apply optional flag by altering chunk and pattern
-                    if ($optional) {
-                        $chunk = '\/' . $chunk;
-                        $pattern = '(?:\/' . $pattern . ')?';
-                    }
-
-                    $compiled = str_replace($chunk, $pattern, $compiled);
-
-                    $this->tokens[] = shape('token' => $token, 'optional' => $optional);
-                }
-            } else {
-                $this->setStatic(true);
-            }
+            return $this->compiled = $cached['compiled'];
         }
 
-        // Append a check for a trailing slash
-        if ($path !== '/') {
-            $compiled .= '\/?';
-        }
+        $compiled = $this->compilePath();
 
-        // Save the compiled regex
-        return $this->compiled = $compiled;
+        RegexCache::set($key, shape(
+            'compiled' => $compiled,
+            'patterns' => $this->getPatterns()->toArray(),
+            'static' => $this->getStatic(),
+            'tokens' => $this->tokens->toArray()
+        ));
+
+        return $compiled;
     }
 
     /**
@@ -222,6 +169,33 @@ class Route implements Serializable {
         return $method->invokeArgs($object, $this->getActionArguments());
     }
 
+    /**
+     * Export the compiled route as a shape of scalar arrays, which can be written to a static Hack file.
+     * Conditions are callbacks and cannot be exported, so routes with conditions cannot be exported,
+     * as they would otherwise match every request once imported.
+     *
+     * @return \Titon\Route\RouteExport
+     * @throws \Titon\Route\Exception\UnexportableRouteException
+     */
+    public function export(): RouteExport {
+        if ($this->getConditions()) {
+            throw new UnexportableRouteException(sprintf('Route %s has conditions and cannot be exported', $this->getPath()));
+        }
+
+        return shape(
+            'class' => get_class($this),
+            'action' => $this->getAction(),
+            'compiled' => $this->compile(),
+            'filters' => $this->getFilters()->toArray(),
+            'methods' => $this->getMethods()->toArray(),
+            'patterns' => $this->getPatterns()->toArray(),
+            'path' => $this->getPath(),
+            'secure' => $this->getSecure(),
+            'static' => $this->getStatic(),
+            'tokens' => $this->getTokens()->toArray()
+        );
+    }
+
     /**
      * Return the action to dispatch to.
      *
@@ -286,9 +260,36 @@ class Route implements Serializable {
      * @return \Titon\Route\TokenList
      */
     public function getTokens(): TokenList {
+        $this->compile();
+
         return $this->tokens;
     }
 
+    /**
+     * Create a route from exported data without calling the constructor or compiling the path.
+     *
+     * @param \Titon\Route\RouteExport $data
+     * @return \Titon\Route\Route
+     */
+    public static function import(RouteExport $data): Route {
+        $route = (new ReflectionClass($data['class']))->newInstanceWithoutConstructor();
+
+        invariant($route instanceof Route, 'Must be a Route.');
+
+        $route->action = $data['action'];
+        $route->compiled = $data['compiled'];
+        $route->path = $data['path'];
+        $route->tokens = new Vector($data['tokens']);
+
+        $route->setFilters(new Vector($data['filters']));
+        $route->setMethods(new Vector($data['methods']));
+        $route->setPatterns(new Map($data['patterns']));
+        $route->setSecure($data['secure']);
+        $route->setStatic($data['static']);
+
+        return $route;
+    }
+
     /**
      * Has the regex pattern been compiled?
      *
@@ -334,6 +335,16 @@ class Route implements Serializable {
         return false;
     }
 
+    /**
+     * Return true if the path contains no tokens or regex characters,
+     * and can be matched by a case-insensitive direct comparison.
+     *
+     * @return bool
+     */
+    public function isLiteral(): bool {
+        return (strpbrk($this->getPath(), '\\^$|?*+()[]{}<>~') === false);
+    }
+
     /**
      * Return true if the route has been matched.
      *
@@ -429,19 +440,20 @@ class Route implements Serializable {
     }
 
     /**
-     * Serialize the compiled route for increasing performance when caching mapped routes.
+     * Serialize the route for increasing performance when caching mapped routes.
+     * Routes are not compiled beforehand, as compilation happens lazily and is shared through the `RegexCache`.
      */
     public function serialize(): string {
         return serialize(Map {
             'action' => $this->getAction(),
-            'compiled' => $this->compile(),
+            'compiled' => $this->compiled,
             'filters' => $this->getFilters(),
             'methods' => $this->getMethods(),
             'patterns' => $this->getPatterns(),
             'path' => $this->getPath(),
             'secure' => $this->getSecure(),
             'static' => $this->getStatic(),
-            'tokens' => $this->getTokens()
+            'tokens' => $this->tokens
         });
     }
 
@@ -498,6 +510,91 @@ class Route implements Serializable {
         return $this->url;
     }
 
+    /**
+     * Parse the tokens from the path and convert them into a regex pattern.
+     *
+     * @return string
+     * @throws \Titon\Route\Exception\MissingPatternException
+     */
+    protected function compilePath(): string {
+        $path = $this->getPath();
+        $compiled = str_replace(['/', '.'], ['\/', '\.'], $path);
+        $patterns = $this->getPatterns();
+
+        if (!$this->isStatic()) {
+            $tokens = [];
+            $matches = [];
+
+            // Match regex pattern tokens first
+            preg_match_all('/(\<)([^\<\>]+)(\>)/i', $path, $matches, PREG_SET_ORDER);
+            $tokens = array_merge($tokens, $matches);
+
+            // Then match regular tokens
+            preg_match_all('/(\{|\(|\[)([a-z0-9\?]+)(\}|\)|\])/i', $path, $matches, PREG_SET_ORDER);
+            $tokens = array_merge($tokens, $matches);
+
+            if ($tokens) {
+                foreach ($tokens as $match) {
+                    $chunk = $match[0];
+                    $open = array_key_exists(1, $match) ? $match[1] : ''; // opening brace
+                    $token = array_key_exists(2, $match) ? $match[2] : ''; // token
+                    $close = array_key_exists(3, $match) ? $match[3] : ''; // closing brace
+                    $optional = false;
+
+                    // Is the token optional
+                    if (substr($token, -1) === '?') {
+                        $optional = true;
+                        $token = substr($token, 0, strlen($token) - 1);
+                    }
+
+                    // Pattern exists
+                    if (strpos($token, ':') !== false) {
+                        list($token, $pattern) = explode(':', $token, 2);
+
+                        $patterns[$token] = $pattern;
+                        $this->addPattern($token, $pattern);
+                    }
+
+                    if ($open === '{' && $close === '}') {
+                        $pattern = self::ALNUM;
+
+                    } else if ($open === '[' && $close === ']') {
+                        $pattern = self::NUMERIC;
+
+                    } else if ($open === '(' && $close === ')') {
+                        $pattern = self::WILDCARD;
+
+                    } else if ($open === '<' && $close === '>' && $patterns->contains($token)) {
+                        $pattern = '(' . trim($patterns[$token], '()') . ')';
+
+                    } else {
+                        throw new MissingPatternException(sprintf('Unknown pattern for %s token', $token));
+                    }
+
+                    // Apply optional flag by altering chunk and pattern
+                    if ($optional) {
+                        $chunk = '\/' . $chunk;
+                        $pattern = '(?:\/' . $pattern . ')?';
+                    }
+
+                    $compiled = str_replace($chunk, $pattern, $compiled);
+
+                    $this->tokens[] = shape('token' => $token, 'optional' => $optional);
+                }
+            } else {
+                $this->setStatic(true);
+            }
+        }
+
+        // Append a check for a trailing slash
+        if ($path !== '/') {
+            $compiled .= '\/?';
+        }
+
+        // Save the compiled regex
+        return $this->compiled = $compiled;
+    }
+
     /**
      * Gather a list of arguments to pass to the dispatcher based on the tokens and params from the route.
      * Furthermore, loop through and set any default values using reflection, and type cast appropriately.
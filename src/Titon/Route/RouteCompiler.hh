@@ -0,0 +1,74 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+/**
+ * The RouteCompiler exports a map of routes, with their regex patterns already compiled,
+ * into a static Hack file that returns plain arrays. Loading the generated file is an include,
+ * which is cached by the bytecode cache, instead of an unserialize of the route objects on every request.
+ *
+ * Routes with conditions and callback routes cannot be exported, as closures have no static representation.
+ *
+ * @package Titon\Route
+ */
+class RouteCompiler {
+
+    /**
+     * Generate the source code of a Hack file that returns the exported routes.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return string
+     * @throws \Titon\Route\Exception\UnexportableRouteException
+     */
+    public static function compile(RouteMap $routes): string {
+        $table = [];
+
+        foreach ($routes as $key => $route) {
+            $table[$key] = $route->export();
+        }
+
+        return sprintf("<?hh // Generated by Titon\\Route\\RouteCompiler, do not modify.\nreturn %s;\n", var_export($table, true));
+    }
+
+    /**
+     * Include a generated file and import each route from it.
+     *
+     * @param string $path
+     * @return \Titon\Route\RouteMap
+     * @throws \Titon\Common\Exception\MissingFileException
+     */
+    public static function load(string $path): RouteMap {
+        $routes = Map {};
+
+        foreach (include_file($path) as $key => $data) {
+            $routes[(string) $key] = Route::import($data);
+        }
+
+        return $routes;
+    }
+
+    /**
+     * Compile the routes and write them to a file. The file is written to a temporary path first
+     * and then renamed, so that concurrent requests never include a partially written file.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @param string $path
+     * @return bool
+     * @throws \Titon\Route\Exception\UnexportableRouteException
+     */
+    public static function write(RouteMap $routes, string $path): bool {
+        $temp = sprintf('%s.%s.tmp', $path, uniqid());
+
+        if (file_put_contents($temp, static::compile($routes)) === false) {
+            return false;
+        }
+
+        return rename($temp, $path);
+    }
+
+}
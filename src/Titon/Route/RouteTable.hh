@@ -0,0 +1,155 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Route;
+
+use Titon\Utility\State\Server;
+
+/**
+ * The RouteTable matches against exported routes, which are immutable arrays of scalars that can live in
+ * shared memory (like APC) without being unserialized. A `Route` object is only created for routes that are
+ * matched or requested, instead of for every route in the table.
+ *
+ * Routes with conditions cannot be exported, so routes in the table are always valid.
+ *
+ * @package Titon\Route
+ */
+class RouteTable {
+
+    /**
+     * Keys of the routes that have been created from the table, keyed by the object hash of the route.
+     *
+     * @var Map<string, string>
+     */
+    protected Map<string, string> $keys = Map {};
+
+    /**
+     * Routes that have been created from the table.
+     *
+     * @var \Titon\Route\RouteMap
+     */
+    protected RouteMap $routes = Map {};
+
+    /**
+     * Exported routes keyed by route key.
+     *
+     * @var array<string, \Titon\Route\RouteExport>
+     */
+    protected array<string, RouteExport> $table;
+
+    /**
+     * Store the exported routes.
+     *
+     * @param array<string, \Titon\Route\RouteExport> $table
+     */
+    public function __construct(array<string, RouteExport> $table) {
+        $this->table = $table;
+    }
+
+    /**
+     * Export a map of routes into a table.
+     *
+     * @param \Titon\Route\RouteMap $routes
+     * @return \Titon\Route\RouteTable
+     * @throws \Titon\Route\Exception\UnexportableRouteException
+     */
+    public static function fromRoutes(RouteMap $routes): RouteTable {
+        $table = [];
+
+        foreach ($routes as $key => $route) {
+            $table[$key] = $route->export();
+        }
+
+        return new static($table);
+    }
+
+    /**
+     * Return the key of a route that has been created from the table, or null if it was not.
+     *
+     * @param \Titon\Route\Route $route
+     * @return string
+     */
+    public function getKey(Route $route): ?string {
+        return $this->keys->get(spl_object_hash($route));
+    }
+
+    /**
+     * Return a route by key, or null if it does not exist. The route is created on first access.
+     *
+     * @param string $key
+     * @return \Titon\Route\Route
+     */
+    public function getRoute(string $key): ?Route {
+        if ($this->routes->contains($key)) {
+            return $this->routes[$key];
+        }
+
+        if (!array_key_exists($key, $this->table)) {
+            return null;
+        }
+
+        $route = Route::import($this->table[$key]);
+
+        $this->keys[spl_object_hash($route)] = $key;
+
+        return $this->routes[$key] = $route;
+    }
+
+    /**
+     * Return the routes that have been created from the table.
+     *
+     * @return \Titon\Route\RouteMap
+     */
+    public function getRoutes(): RouteMap {
+        return $this->routes;
+    }
+
+    /**
+     * Return the exported routes.
+     *
+     * @return array<string, \Titon\Route\RouteExport>
+     */
+    public function getTable(): array<string, RouteExport> {
+        return $this->table;
+    }
+
+    /**
+     * Attempt to match a URL against the exported routes, using the same rules as `Route::isMatch()`.
+     * Only the matched route is created.
+     *
+     * @param string $url
+     * @return \Titon\Route\Route
+     */
+    public function match(string $url): ?Route {
+        $method = strtolower((string) Server::get('REQUEST_METHOD'));
+        $secure = (Server::get('HTTPS') === 'on' || Server::get('SERVER_PORT') === '443');
+
+        foreach ($this->table as $key => $data) {
+            if (($data['methods'] && !in_array($method, $data['methods'], true)) || ($data['secure'] && !$secure)) {
+                continue;
+            }
+
+            $matches = [];
+
+            if ($data['path'] === $url) {
+                $matches = [$url];
+
+            } else if (!preg_match('~^' . $data['compiled'] . '$~i', $url, $matches)) {
+                continue;
+            }
+
+            $route = $this->getRoute($key);
+
+            invariant($route !== null, 'Route must exist.');
+
+            return $route->match($matches);
+        }
+
+        return null;
+    }
+
+}
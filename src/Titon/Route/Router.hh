@@ -20,10 +20,12 @@ use Titon\Route\Exception\InvalidRouteActionException;
 use Titon\Route\Exception\MissingFilterException;
 use Titon\Route\Exception\MissingRouteException;
 use Titon\Route\Exception\NoMatchException;
+use Titon\Route\Exception\UnexportableRouteException;
 use Titon\Route\Matcher\LoopMatcher;
 use Titon\Route\Mixin\MethodList;
 use Titon\Route\Group as RouteGroup; // Will fatal without alias
 use Titon\Utility\Registry;
+use Titon\Utility\State\Server;
 
 /**
  * The Router is tasked with the management of routes and matching of routes.
@@ -34,7 +36,12 @@ class Router implements Subject {
     use EmitsEvents;
 
     /**
-     * Have routes been loaded in from the cache?
+     * Bucket key for routes that respond to any HTTP method.
+     */
+    const string ANY = 'any';
+
+    /**
+     * Have routes been loaded in from, or written to, the cache?
      *
      * @var bool
      */
@@ -68,6 +75,28 @@ class Router implements Subject {
      */
     protected Matcher $matcher;
 
+    /**
+     * Optional cache of match results for repeated requests.
+     *
+     * @var \Titon\Route\MatchCache
+     */
+    protected ?MatchCache $matchCache;
+
+    /**
+     * Routes partitioned by the HTTP method they respond to, in mapping order.
+     * Routes that respond to any method are merged into every bucket.
+     *
+     * @var \Titon\Route\MethodRouteMap
+     */
+    protected MethodRouteMap $methodRoutes = Map {};
+
+    /**
+     * Key of every mapped route, and whether its matches can be cached, keyed by the object hash of the route.
+     *
+     * @var \Titon\Route\RouteLookupMap
+     */
+    protected RouteLookupMap $lookups = Map {};
+
     /**
      * Mapping of CRUD actions to URL path parts for REST resources.
      * These mappings will be used when creating resource() routes.
@@ -95,6 +124,27 @@ class Router implements Subject {
      */
     protected RouteMap $routes = Map {};
 
+    /**
+     * Cache routes as an exported table of arrays, instead of serialized objects.
+     *
+     * @var bool
+     */
+    protected bool $shared = false;
+
+    /**
+     * Has the static index been built since routes were last mapped?
+     *
+     * @var bool
+     */
+    protected bool $staticIndexed = false;
+
+    /**
+     * Mapping of lowercased literal paths to the keys of routes that can be matched by direct comparison.
+     *
+     * @var \Titon\Route\StaticMap
+     */
+    protected StaticMap $staticRoutes = Map {};
+
     /**
      * Storage engine instance.
      *
@@ -102,6 +152,13 @@ class Router implements Subject {
      */
     protected ?Storage $storage;
 
+    /**
+     * Exported route table loaded from a shared cache.
+     *
+     * @var \Titon\Route\RouteTable
+     */
+    protected ?RouteTable $table;
+
     /**
      * Initialize the router and prepare for matching.
      */
@@ -161,13 +218,28 @@ class Router implements Subject {
         }
 
         if (($storage = $router->getStorage()) && ($routes = $router->getRoutes())) {
-            // Before caching, make sure all routes are compiled
-            foreach ($routes as $route) {
-                $route->compile();
+
+            $table = null;
+
+            // Exported routes are plain arrays, which shared memory storage can return without unserializing
+            if ($router->isShared()) {
+                try {
+                    $table = RouteTable::fromRoutes($routes)->getTable();
+                } catch (UnexportableRouteException $e) {
+                    // Fall back to serializing when a single route cannot be exported
+                }
             }
 
-            // Compiling before hand should speed up the next request
-            $storage->save(new Item('routes', serialize($routes), '+1 year'));
+            if ($table !== null) {
+                $storage->save(new Item('routes.table', $table, '+1 year'));
+
+            // Routes are compiled lazily when matched, so they are cached as is
+            } else {
+                $storage->save(new Item('routes', serialize($routes), '+1 year'));
+            }
+
+            // The mapped routes are now in sync with the cache, so they are not loaded back in
+            $this->cached = true;
         }
 
         return true;
@@ -203,11 +275,38 @@ class Router implements Subject {
     public function doLoadRoutes(Event $event): mixed {
         invariant($event instanceof MatchingEvent, 'Must be a MatchingEvent.');
 
-        $item = $event->getRouter()->getStorage()?->getItem('routes');
+        $router = $event->getRouter();
+
+        // Routes are only loaded once, so that the indexes derived from them are kept between matches
+        if ($router->isCached()) {
+            return true;
+        }
+
+        if ($router->isShared()) {
+            $item = $router->getStorage()?->getItem('routes.table');
+
+            if ($item !== null && $item->isHit()) {
+                $table = $item->get();
+
+                invariant(is_array($table), 'Route table must be an array.');
+
+                $this->table = new RouteTable($table);
+                $this->cached = true;
+
+                $this->clearIndexes();
+
+                return true;
+            }
+        }
+
+        // Shared routers fall back to serialized routes, which are cached when a route cannot be exported
+        $item = $router->getStorage()?->getItem('routes');
 
         if ($item !== null && $item->isHit()) {
             $this->routes = unserialize($item->get());
             $this->cached = true;
+
+            $this->clearIndexes();
         }
 
         return true;
@@ -283,6 +382,32 @@ class Router implements Subject {
         return $this->groups;
     }
 
+    /**
+     * Return the routes that can respond to an HTTP method, in mapping order.
+     * If no route explicitly defines the method, only routes that respond to any method are returned.
+     *
+     * @param string $method
+     * @return \Titon\Route\RouteMap
+     */
+    public function getMethodRoutes(string $method): RouteMap {
+        if (!$this->methodRoutes) {
+            $this->buildMethodRoutes();
+        }
+
+        $routes = $this->methodRoutes->get(strtolower($method));
+
+        return ($routes !== null) ? $routes : $this->methodRoutes[self::ANY];
+    }
+
+    /**
+     * Return the match result cache if one has been set.
+     *
+     * @return \Titon\Route\MatchCache
+     */
+    public function getMatchCache(): ?MatchCache {
+        return $this->matchCache;
+    }
+
     /**
      * Return the matcher object.
      *
@@ -309,6 +434,10 @@ class Router implements Subject {
      * @throws \Titon\Route\Exception\MissingRouteException
      */
     public function getRoute(string $key): Route {
+        if ($route = $this->table?->getRoute($key)) {
+            return $route;
+        }
+
         if ($this->routes->contains($key)) {
             return $this->routes[$key];
         }
@@ -325,6 +454,19 @@ class Router implements Subject {
         return $this->routes;
     }
 
+    /**
+     * Return the index of static route keys. The index is built lazily during the first match.
+     *
+     * @return \Titon\Route\StaticMap
+     */
+    public function getStaticRoutes(): StaticMap {
+        if (!$this->staticIndexed) {
+            $this->buildStaticRoutes();
+        }
+
+        return $this->staticRoutes;
+    }
+
     /**
      * Get the storage engine.
      *
@@ -377,7 +519,16 @@ class Router implements Subject {
     }
 
     /**
-     * Return true if routes have been loaded from a cache.
+     * Return the route table if one was loaded from a shared cache.
+     *
+     * @return \Titon\Route\RouteTable
+     */
+    public function getTable(): ?RouteTable {
+        return $this->table;
+    }
+
+    /**
+     * Return true if routes have been loaded from, or written to, a cache.
      *
      * @return bool
      */
@@ -385,6 +536,33 @@ class Router implements Subject {
         return $this->cached;
     }
 
+    /**
+     * Return true if routes are cached as an exported table.
+     *
+     * @return bool
+     */
+    public function isShared(): bool {
+        return $this->shared;
+    }
+
+    /**
+     * Load routes from a file generated by the `RouteCompiler`, replacing all currently mapped routes.
+     * Routes loaded this way are flagged as cached, so they will not be written to the cache storage.
+     *
+     * @param string $path
+     * @return $this
+     * @throws \Titon\Common\Exception\MissingFileException
+     */
+    public function loadCompiled(string $path): this {
+        $this->routes = RouteCompiler::load($path);
+        $this->table = null;
+        $this->cached = true;
+
+        $this->clearIndexes();
+
+        return $this;
+    }
+
     /**
      * Add a custom defined route object that matches to an internal destination.
      *
@@ -394,6 +572,7 @@ class Router implements Subject {
      */
     public function map(string $key, Route $route): Route {
         $this->routes[$key] = $route;
+        $this->clearIndexes();
 
         // Apply group options
         foreach ($this->getGroups() as $group) {
@@ -428,7 +607,13 @@ class Router implements Subject {
     }
 
     /**
-     * Attempt to match an internal route.
+     * Attempt to match an internal route. Routes with a literal path are resolved through
+     * the static index first, before the matcher is used. A literal route is only indexed if no route
+     * mapped before it could match its path, so the first mapped route always wins.
+     * The matcher is only given the routes that can respond to the current HTTP method.
+     *
+     * If a match cache has been set, previous results for the same request are re-used instead.
+     * If a route table was loaded from a shared cache, it is matched against directly.
      *
      * @param string $url
      * @return \Titon\Route\Route
@@ -437,7 +622,22 @@ class Router implements Subject {
     public function match(string $url): Route {
         $this->emit(new MatchingEvent($this, $url));
 
-        $match = $this->getMatcher()->match($url, $this->getRoutes());
+        $cache = $this->getMatchCache();
+        $cacheKey = $cache ? $this->getMatchCacheKey($url) : '';
+        $match = $cache ? $this->matchCached($cache, $cacheKey) : null;
+
+        if (!$match) {
+            if ($this->table) {
+                $match = $this->table->match($url);
+            } else {
+                $match = $this->matchStatic($url) ?:
+                    $this->getMatcher()->match($url, $this->getMethodRoutes((string) Server::get('REQUEST_METHOD')));
+            }
+
+            if ($match && $cache && ($key = $this->getCacheableKey($match)) !== null) {
+                $this->cacheMatch($cache, $cacheKey, $key, $match);
+            }
+        }
 
         if (!$match) {
             throw new NoMatchException(sprintf('No route has been matched for %s', $url));
@@ -596,6 +796,33 @@ class Router implements Subject {
         return $this;
     }
 
+    /**
+     * Set the cache to store match results in.
+     *
+     * @param \Titon\Route\MatchCache $cache
+     * @return $this
+     */
+    public function setMatchCache(MatchCache $cache): this {
+        $this->matchCache = $cache;
+
+        return $this;
+    }
+
+    /**
+     * Cache routes as an exported table of arrays, instead of serialized objects. When combined with a shared memory
+     * storage, like `ApcStorage`, the table is read without being unserialized, and routes are matched directly
+     * against it, so that only the matched route is created. If any route cannot be exported, like callback routes
+     * and routes with conditions, all routes are serialized instead.
+     *
+     * @param bool $shared
+     * @return $this
+     */
+    public function setShared(bool $shared): this {
+        $this->shared = $shared;
+
+        return $this;
+    }
+
     /**
      * Update the resource mapping.
      *
@@ -649,4 +876,272 @@ class Router implements Subject {
         return $this;
     }
 
+    /**
+     * Add a route with a literal path to the static index.
+     *
+     * @param string $key
+     * @param \Titon\Route\Route $route
+     */
+    protected function addStaticRoute(string $key, Route $route): void {
+        $path = strtolower($route->getPath());
+
+        if (!$this->staticRoutes->contains($path)) {
+            $this->staticRoutes[$path] = Vector {};
+        }
+
+        $keys = $this->staticRoutes[$path];
+
+        if (!in_array($key, $keys, true)) {
+            $keys[] = $key;
+        }
+    }
+
+    /**
+     * Store the result of a match in the cache.
+     *
+     * @param \Titon\Route\MatchCache $cache
+     * @param string $cacheKey
+     * @param string $key
+     * @param \Titon\Route\Route $match
+     */
+    protected function cacheMatch(MatchCache $cache, string $cacheKey, string $key, Route $match): void {
+        $cache->set($cacheKey, shape(
+            'key' => $key,
+            'url' => $match->url(),
+            'params' => $match->getParams()->toArray()
+        ));
+    }
+
+    /**
+     * Index the key of every mapped route, in mapping order. A match can only be cached if neither the route,
+     * nor any route mapped before it, has conditions, as conditions may depend on the request and
+     * an earlier route could win the next time. The index is built lazily during the first match.
+     */
+    protected function buildLookups(): void {
+        $cacheable = true;
+
+        foreach ($this->routes as $key => $route) {
+            $hash = spl_object_hash($route);
+
+            if ($route->getConditions()) {
+                $cacheable = false;
+            }
+
+            if (!$this->lookups->contains($hash)) {
+                $this->lookups[$hash] = shape('key' => $key, 'cacheable' => $cacheable);
+            }
+        }
+    }
+
+    /**
+     * Partition the mapped routes into buckets by HTTP method. The buckets are built lazily
+     * during the first match, so that methods added to a route after mapping are respected.
+     */
+    protected function buildMethodRoutes(): void {
+        $buckets = Map {self::ANY => Map {}};
+
+        foreach ($this->routes as $route) {
+            foreach ($route->getMethods() as $method) {
+                if (!$buckets->contains($method)) {
+                    $buckets[$method] = Map {};
+                }
+            }
+        }
+
+        foreach ($this->routes as $key => $route) {
+            $methods = $route->getMethods();
+
+            foreach ($buckets as $method => $bucket) {
+                if (!$methods || in_array($method, $methods, true)) {
+                    $bucket[$key] = $route;
+                }
+            }
+        }
+
+        $this->methodRoutes = $buckets;
+    }
+
+    /**
+     * Clear the indexes that are derived from the mapped routes, so that they are rebuilt during the next match.
+     * This includes the index of the matcher, if it keeps one.
+     */
+    protected function clearIndexes(): void {
+        $this->lookups->clear();
+        $this->methodRoutes->clear();
+        $this->staticRoutes->clear();
+        $this->staticIndexed = false;
+        $this->matchCache?->flush();
+
+        if ($this->matcher instanceof IndexedMatcher) {
+            $this->matcher->reset();
+        }
+    }
+
+    /**
+     * Return the key of a matched route if its match can be cached, or null otherwise.
+     * Routes in a route table can not have conditions, so their matches can always be cached.
+     *
+     * @param \Titon\Route\Route $match
+     * @return string
+     */
+    protected function getCacheableKey(Route $match): ?string {
+        if ($this->table) {
+            return $this->table->getKey($match);
+        }
+
+        if (!$this->lookups) {
+            $this->buildLookups();
+        }
+
+        $lookup = $this->lookups->get(spl_object_hash($match));
+
+        return ($lookup !== null && $lookup['cacheable']) ? $lookup['key'] : null;
+    }
+
+    /**
+     * Return the key for the match cache, derived from the parts of the request that affect matching.
+     *
+     * @param string $url
+     * @return string
+     */
+    protected function getMatchCacheKey(string $url): string {
+        $secure = (Server::get('HTTPS') === 'on' || Server::get('SERVER_PORT') === '443');
+
+        return sprintf('%s %s://%s%s', strtolower((string) Server::get('REQUEST_METHOD')), $secure ? 'https' : 'http', (string) Server::get('HTTP_HOST'), $url);
+    }
+
+    /**
+     * Attempt to match a URL using a previously cached result.
+     *
+     * @param \Titon\Route\MatchCache $cache
+     * @param string $cacheKey
+     * @return \Titon\Route\Route
+     */
+    protected function matchCached(MatchCache $cache, string $cacheKey): ?Route {
+        $result = $cache->get($cacheKey);
+
+        if ($result === null) {
+            return null;
+        }
+
+        $route = $this->table ? $this->table->getRoute($result['key']) : $this->routes->get($result['key']);
+
+        if ($route === null) {
+            return null;
+        }
+
+        // Rebuild the matches in the same order the regex would return them
+        $matches = [$result['url']];
+
+        foreach ($result['params'] as $param) {
+            if ($param === null) {
+                break;
+            }
+
+            $matches[] = (string) $param;
+        }
+
+        return $route->match($matches);
+    }
+
+    /**
+     * Rebuild the static index for all mapped routes. A literal route is skipped if a non-literal route
+     * mapped before it could match its path, as the matcher must then decide which route wins.
+     * Only the non-literal routes whose leading literal segments share a prefix with the path are compiled.
+     */
+    protected function buildStaticRoutes(): void {
+        $this->staticRoutes->clear();
+        $this->staticIndexed = true;
+
+        $dynamic = Vector {};
+
+        foreach ($this->routes as $key => $route) {
+            if (!$route->isLiteral()) {
+                $dynamic[] = $route;
+                continue;
+            }
+
+            $path = $route->getPath();
+            $shadowed = false;
+
+            foreach ($dynamic as $earlier) {
+                if ($this->isShadowing($earlier, $path)) {
+                    $shadowed = true;
+                    break;
+                }
+            }
+
+            if (!$shadowed) {
+                $this->addStaticRoute($key, $route);
+            }
+        }
+    }
+
+    /**
+     * Return true if a non-literal route could match a literal path, regardless of the request.
+     * Routes are only compiled when the literal part of their path, up to the last slash before
+     * the first token or regex character, is a prefix of the path.
+     *
+     * @param \Titon\Route\Route $route
+     * @param string $path
+     * @return bool
+     */
+    protected function isShadowing(Route $route, string $path): bool {
+        $pattern = $route->getPath();
+
+        // Alternation may apply to the whole path, so the prefix can not be trusted
+        if (strpos($pattern, '|') === false) {
+            $length = (int) strrpos(substr($pattern, 0, strcspn($pattern, '\\^$|?*+()[]{}<>~')), '/');
+
+            if ($length > 0 && strncasecmp($path, $pattern, $length) !== 0) {
+                return false;
+            }
+        }
+
+        return (bool) preg_match('~^' . $route->compile() . '$~i', $path);
+    }
+
+    /**
+     * Attempt to match a URL against the static index, without running the matcher.
+     * A trailing slash and casing are handled in the same way as the compiled route regex.
+     *
+     * @param string $url
+     * @return \Titon\Route\Route
+     */
+    protected function matchStatic(string $url): ?Route {
+        $path = $url;
+
+        if ($path !== '/' && substr($path, -1) === '/') {
+            $path = substr($path, 0, -1);
+
+            if ($path === '/' || $path === '') {
+                return null; // The root path does not support a trailing slash
+            }
+        }
+
+        $path = strtolower($path);
+        $keys = $this->getStaticRoutes()->get($path);
+
+        if ($keys === null) {
+            return null;
+        }
+
+        foreach ($keys as $key) {
+            $route = $this->routes->get($key);
+
+            // The route may have been replaced or modified since it was indexed
+            if ($route === null || !$route->isLiteral() || strtolower($route->getPath()) !== $path) {
+                continue;
+            }
+
+            if ($route->isMethod() && $route->isSecure() && $route->isValid()) {
+                $route->match([$url]);
+
+                return $route;
+            }
+        }
+
+        return null;
+    }
+
 }
@@ -36,6 +36,13 @@ class UrlBuilder {
      */
     protected Router $router;
 
+    /**
+     * Compiled URL templates keyed by route key.
+     *
+     * @var \Titon\Route\UrlTemplateMap
+     */
+    protected UrlTemplateMap $templates = Map {};
+
     /**
      * The current URL broken up into multiple segments: protocol, host, route, query, base, etc.
      *
@@ -77,53 +84,48 @@ class UrlBuilder {
      * @return string
      * @throws \Titon\Route\Exception\MissingTokenException
      */
-    <<__Memoize>>
     public function build(string $key, ParamMap $params = Map {}, QueryMap $query = Map {}): string {
-        $base = $this->getBase();
-        $route = $this->getRouter()->getRoute($key);
-        $url = str_replace([']', ')', '>'], '}', str_replace(['[', '(', '<'], '{', $route->getPath()));
-
-        // Set the locale if it is missing
-        if (!$params->contains('locale')) {
-            $params['locale'] = Config::get('titon.locale.current');
-        }
-
-        // Replace tokens in the path with values from the parameters
-        foreach ($route->getTokens() as $token) {
-            $tokenKey = $token['token'];
-
-            if ($params->contains($tokenKey) || $token['optional']) {
-                $url = str_replace(sprintf('{%s}', $tokenKey . ($token['optional'] ? '?' : '')), Inflect::route((string) $params->get($tokenKey) ?: ''), $url);
-
-            } else {
-                throw new MissingTokenException(sprintf('Missing %s parameter for the %s route', $tokenKey, $key));
-            }
-        }
-
-        // Prepend base folder
-        if ($base !== '/') {
-            $url = $base . $url;
-        }
+        return $this->buildMany($key, Vector {$params}, $query)[0];
+    }
 
-        // Trim trailing slash
-        if ($url !== '/') {
-            $url = rtrim($url, '/');
-        }
+    /**
+     * Builds multiple URLs for the same route, one for each set of parameters.
+     * The route template, base folder, and query string are only resolved once for the whole batch.
+     *
+     * @param string $key
+     * @param \Titon\Route\ParamList $paramsList
+     * @param \Titon\Route\QueryMap $query
+     * @return Vector<string>
+     * @throws \Titon\Route\Exception\MissingTokenException
+     */
+    public function buildMany(string $key, ParamList $paramsList, QueryMap $query = Map {}): Vector<string> {
+        $template = $this->getTemplate($key);
+        $base = $this->getBase();
+        $prefix = ($base !== '/') ? $base : '';
+        $suffix = '';
 
         // Append query string and fragment
         $fragment = $query->get('#');
-
-        $query->remove('#');
+        $query = $query->filterWithKey(($name, $value) ==> $name !== '#');
 
         if ($query) {
-            $url .= '?' . http_build_query($query);
+            $suffix .= '?' . http_build_query($query);
         }
 
         if ($fragment !== null) {
-            $url .= '#' . (($fragment instanceof Traversable) ? http_build_query($fragment) : urlencode($fragment));
+            $suffix .= '#' . (($fragment instanceof Traversable) ? http_build_query($fragment) : urlencode($fragment));
         }
 
-        return $url;
+        return $paramsList->map($params ==> {
+            $url = $prefix . $this->fillTemplate($key, $template, $params);
+
+            // Trim trailing slash
+            if ($url !== '/') {
+                $url = rtrim($url, '/');
+            }
+
+            return $url . $suffix;
+        });
     }
 
     /**
@@ -191,4 +193,86 @@ class UrlBuilder {
         return $this->segments;
     }
 
+    /**
+     * Return the URL template for a route, or compile it if it does not exist.
+     * The template splits the route path into literal chunks, with a token slot between each chunk,
+     * so that building a URL is a single concatenation pass.
+     *
+     * @param string $key
+     * @return \Titon\Route\UrlTemplate
+     * @throws \Titon\Route\Exception\MissingRouteException
+     */
+    public function getTemplate(string $key): UrlTemplate {
+        $route = $this->getRouter()->getRoute($key);
+        $template = $this->templates->get($key);
+
+        // The route may have been re-mapped since the template was compiled
+        if ($template !== null && $template['route'] === $route) {
+            return $template;
+        }
+
+        $tokens = Map {};
+
+        foreach ($route->getTokens() as $token) {
+            $tokens[sprintf('{%s}', $token['token'] . ($token['optional'] ? '?' : ''))] = $token;
+        }
+
+        $path = str_replace([']', ')', '>'], '}', str_replace(['[', '(', '<'], '{', $route->getPath()));
+        $parts = preg_split('/(\{[^\{\}]+\})/', $path, -1, PREG_SPLIT_DELIM_CAPTURE);
+        $chunks = [];
+        $slots = [];
+        $literal = '';
+
+        foreach ($parts as $part) {
+            if ($tokens->contains($part)) {
+                $chunks[] = $literal;
+                $slots[] = $tokens[$part];
+                $literal = '';
+            } else {
+                $literal .= $part;
+            }
+        }
+
+        $chunks[] = $literal;
+
+        return $this->templates[$key] = shape(
+            'route' => $route,
+            'chunks' => $chunks,
+            'tokens' => $slots
+        );
+    }
+
+    /**
+     * Join the literal chunks of a template with the inflected parameter for each token slot.
+     *
+     * @param string $key
+     * @param \Titon\Route\UrlTemplate $template
+     * @param \Titon\Route\ParamMap $params
+     * @return string
+     * @throws \Titon\Route\Exception\MissingTokenException
+     */
+    protected function fillTemplate(string $key, UrlTemplate $template, ParamMap $params): string {
+        $chunks = $template['chunks'];
+        $url = $chunks[0];
+
+        foreach ($template['tokens'] as $i => $token) {
+            $tokenKey = $token['token'];
+
+            // Set the locale if it is missing
+            if ($tokenKey === 'locale' && !$params->contains('locale')) {
+                $value = Config::get('titon.locale.current');
+
+            } else if ($params->contains($tokenKey) || $token['optional']) {
+                $value = $params->get($tokenKey);
+
+            } else {
+                throw new MissingTokenException(sprintf('Missing %s parameter for the %s route', $tokenKey, $key));
+            }
+
+            $url .= Inflect::route((string) $value ?: '') . $chunks[$i + 1];
+        }
+
+        return $url;
+    }
+
 }
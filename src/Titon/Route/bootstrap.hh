@@ -18,18 +18,65 @@ namespace Titon\Route {
 
     type Action = shape('class' => string, 'action' => string);
     type ArgumentList = array<mixed>;
+    type CompiledMap = Map<string, CompiledRoute>;
+    type CompiledRoute = shape(
+        'compiled' => string,
+        'patterns' => array<string, string>,
+        'static' => bool,
+        'tokens' => array<Token>
+    );
     type FilterCallback = (function(Router, Route): void);
     type FilterMap = Map<string, FilterCallback>;
     type GroupCallback = (function(Router, RouteGroup): void);
     type GroupList = Vector<RouteGroup>;
+    type MatchResult = shape('key' => string, 'url' => string, 'params' => array<string, mixed>);
+    type MatchResultMap = Map<string, MatchResult>;
+    type MethodRouteMap = Map<string, RouteMap>;
+    type ParamList = Vector<ParamMap>;
     type ParamMap = Map<string, mixed>;
     type QueryMap = Map<string, mixed>;
     type ResourceMap = Map<string, string>;
     type RouteCallback = (function(...): mixed);
+    type RouteExport = shape(
+        'class' => string,
+        'action' => Action,
+        'compiled' => string,
+        'filters' => array<string>,
+        'methods' => array<string>,
+        'patterns' => array<string, string>,
+        'path' => string,
+        'secure' => bool,
+        'static' => bool,
+        'tokens' => array<Token>
+    );
+    type RouteLookup = shape('key' => string, 'cacheable' => bool);
+    type RouteLookupMap = Map<string, RouteLookup>;
     type RouteMap = Map<string, Route>;
     type SegmentMap = Map<string, mixed>;
+    type StaticMap = Map<string, Vector<string>>;
     type Token = shape('token' => string, 'optional' => bool);
     type TokenList = Vector<Token>;
+    type UrlTemplate = shape('route' => Route, 'chunks' => array<string>, 'tokens' => array<Token>);
+    type UrlTemplateMap = Map<string, UrlTemplate>;
+}
+
+namespace Titon\Route\Matcher {
+    use Titon\Route\Route;
+    use Titon\Route\RouteMap;
+
+    type CombinedChunk = shape('regex' => string, 'routes' => Map<int, int>);
+    type CombinedMatch = shape('index' => int, 'captures' => array<string>);
+    type TrieCandidate = shape('index' => int, 'order' => int, 'captures' => array<string>);
+    type TrieIndex = shape(
+        'map' => RouteMap,
+        'routes' => Vector<Route>,
+        'fallback' => Vector<int>,
+        'statics' => Vector<Map<string, int>>,
+        'tokens' => Vector<Map<string, int>>,
+        'leaves' => Vector<Vector<TrieLeaf>>
+    );
+    type TrieLeaf = shape('index' => int, 'order' => int, 'slots' => array<bool>, 'root' => bool);
+    type TrieSegment = shape('type' => string, 'value' => string, 'optional' => bool);
 }
 
 namespace Titon\Route\Mixin {
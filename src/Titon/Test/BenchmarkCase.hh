@@ -0,0 +1,86 @@
+<?hh // strict
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+namespace Titon\Test;
+
+type BenchmarkCallback = (function(): mixed);
+type BenchmarkResult = shape(
+    'name' => string,
+    'iterations' => int,
+    'time' => float,
+    'memory' => int,
+    'peakMemory' => int
+);
+type BenchmarkResultList = Vector<BenchmarkResult>;
+
+/**
+ * Provides a lightweight harness for measuring the throughput of a code path.
+ * Every public method prefixed with `bench` is executed by the `bin/run-benchmarks` script.
+ */
+abstract class BenchmarkCase {
+
+    /**
+     * Results of every measurement in the order they were captured.
+     *
+     * @var \Titon\Test\BenchmarkResultList
+     */
+    protected BenchmarkResultList $results = Vector {};
+
+    /**
+     * Return all captured results.
+     *
+     * @return \Titon\Test\BenchmarkResultList
+     */
+    public function getResults(): BenchmarkResultList {
+        return $this->results;
+    }
+
+    /**
+     * Execute the callback a number of times and record the total time, memory growth, and peak memory.
+     * The callback is executed once beforehand to warm up any lazy state.
+     *
+     * @param string $name
+     * @param int $iterations
+     * @param \Titon\Test\BenchmarkCallback $callback
+     * @return $this
+     */
+    public function measure(string $name, int $iterations, BenchmarkCallback $callback): this {
+        $callback();
+
+        $memory = memory_get_usage();
+        $start = microtime(true);
+
+        for ($i = 0; $i < $iterations; $i++) {
+            $callback();
+        }
+
+        $this->results[] = shape(
+            'name' => $name,
+            'iterations' => $iterations,
+            'time' => microtime(true) - $start,
+            'memory' => memory_get_usage() - $memory,
+            'peakMemory' => memory_get_peak_usage()
+        );
+
+        return $this;
+    }
+
+    /**
+     * Setup state before each benchmark method.
+     */
+    public function setUp(): void {
+        return;
+    }
+
+    /**
+     * Reset state after each benchmark method.
+     */
+    public function tearDown(): void {
+        return;
+    }
+
+}
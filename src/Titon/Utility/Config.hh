@@ -25,6 +25,13 @@ class Config {
      */
     protected static ConfigMap $config = Map {};
 
+    /**
+     * Incremented every time the configuration is modified, so that derived values can be cached.
+     *
+     * @var int
+     */
+    protected static int $revision = 0;
+
     /**
      * Add a value to a key. If the value is not a vector, make it one.
      *
@@ -61,6 +68,7 @@ class Config {
      */
     public static function flush(): void {
         static::$config->clear();
+        static::$revision++;
     }
 
     /**
@@ -99,6 +107,7 @@ class Config {
      */
     public static function load(string $key, Reader $reader): void {
         static::$config[$key] = $reader->readResource();
+        static::$revision++;
     }
 
     /**
@@ -117,6 +126,17 @@ class Config {
      */
     public static function remove(string $key): void {
         Col::remove(static::$config, $key);
+        static::$revision++;
+    }
+
+    /**
+     * Return the revision of the configuration, which changes every time the configuration is modified.
+     * Changes made directly to the map returned from `all()` are not tracked.
+     *
+     * @return int
+     */
+    public static function revision(): int {
+        return static::$revision;
     }
 
     /**
@@ -136,6 +156,7 @@ class Config {
      */
     public static function set(string $key, mixed $value): void {
         Col::set(static::$config, $key, $value);
+        static::$revision++;
     }
 
 }
@@ -62,6 +62,25 @@ class CacheTest extends TestCase {
         $this->assertFalse($this->object->has('test', 'custom'));
     }
 
+    public function testGenGet(): void {
+        $this->assertEquals(null, $this->object->genGet('fakeKey')->getWaitHandle()->join()->get());
+        $this->assertEquals('foo', $this->object->genGet('key')->getWaitHandle()->join()->get());
+        $this->assertEquals('bar', $this->object->genGet('key', 'custom')->getWaitHandle()->join()->get());
+    }
+
+    public function testGenGetItems(): void {
+        $items = $this->object->genGetItems(['key', 'fakeKey'], 'custom')->getWaitHandle()->join();
+
+        $this->assertEquals('bar', $items['key']->get());
+        $this->assertFalse($items['fakeKey']->isHit());
+    }
+
+    public function testGenSet(): void {
+        $this->object->genSet('key', 'bar', '+1 hour')->getWaitHandle()->join();
+
+        $this->assertEquals('bar', $this->object->get('key')->get());
+    }
+
     public function testGet(): void {
         $this->assertEquals(null, $this->object->get('fakeKey')->get());
         $this->assertEquals('foo', $this->object->get('key')->get());
@@ -0,0 +1,65 @@
+<?hh
+namespace Titon\Cache;
+
+use Titon\Test\TestCase;
+
+/**
+ * @property \Titon\Cache\Histogram $object
+ */
+class HistogramTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->object = new Histogram();
+    }
+
+    public function testAdd(): void {
+        $this->object->add(0.001);
+        $this->object->add(0.003);
+
+        $this->assertEquals(2, $this->object->getCount());
+        $this->assertEquals(0.003, $this->object->getMax());
+        $this->assertEquals(0.002, $this->object->getMean(), '', 0.000001);
+    }
+
+    public function testPercentile(): void {
+        $this->assertEquals(0.0, $this->object->percentile(50.0));
+
+        for ($i = 0; $i < 99; $i++) {
+            $this->object->add(0.000010); // 10 microseconds
+        }
+
+        $this->object->add(0.5);
+
+        // Upper bound of the 16 microsecond bucket
+        $this->assertEquals(0.000016, $this->object->percentile(50.0));
+        $this->assertEquals(0.000016, $this->object->percentile(99.0));
+
+        // Capped by the longest duration
+        $this->assertEquals(0.5, $this->object->percentile(100.0));
+    }
+
+    public function testReset(): void {
+        $this->object->add(0.001);
+        $this->object->reset();
+
+        $this->assertEquals(0, $this->object->getCount());
+        $this->assertEquals(0.0, $this->object->getMax());
+        $this->assertEquals(0.0, $this->object->percentile(99.0));
+    }
+
+    public function testToMap(): void {
+        $this->object->add(0.001);
+
+        $this->assertEquals(Map {
+            'count' => 1,
+            'mean' => 1.0,
+            'max' => 1.0,
+            'p50' => 1.0,
+            'p95' => 1.0,
+            'p99' => 1.0
+        }, $this->object->toMap());
+    }
+
+}
@@ -40,6 +40,13 @@ class ItemTest extends TestCase {
         $this->assertEquals('baz', $this->object->getKey());
     }
 
+    public function testGetSetTags(): void {
+        $this->assertEquals([], $this->object->getTags());
+
+        $this->object->setTags(['user', 'post', 'user']);
+        $this->assertEquals(['post', 'user'], $this->object->getTags());
+    }
+
     public function testIsHit(): void {
         $this->assertFalse($this->object->isHit());
 
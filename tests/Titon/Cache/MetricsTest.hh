@@ -0,0 +1,64 @@
+<?hh
+namespace Titon\Cache;
+
+use Titon\Test\TestCase;
+
+/**
+ * @property \Titon\Cache\Metrics $object
+ */
+class MetricsTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->object = new Metrics();
+    }
+
+    public function testCount(): void {
+        $this->assertEquals(0, $this->object->getCounter('hits'));
+
+        $this->object->count('hits');
+        $this->object->count('hits', 2);
+
+        $this->assertEquals(3, $this->object->getCounter('hits'));
+        $this->assertEquals(Map {'hits' => 3}, $this->object->getCounters());
+    }
+
+    public function testGetHitRatio(): void {
+        $this->assertEquals(0.0, $this->object->getHitRatio());
+
+        $this->object->count(Storage::HITS, 3);
+        $this->object->count(Storage::MISSES, 1);
+
+        $this->assertEquals(0.75, $this->object->getHitRatio());
+    }
+
+    public function testReset(): void {
+        $this->object->count('hits');
+        $this->object->time('getItem', 0.001);
+        $this->object->reset();
+
+        $this->assertEquals(Map {}, $this->object->getCounters());
+        $this->assertEquals(Map {}, $this->object->getLatencies());
+    }
+
+    public function testTime(): void {
+        $this->object->time('getItem', 0.001);
+        $this->object->time('getItem', 0.002);
+
+        $this->assertEquals(2, $this->object->getLatency('getItem')->getCount());
+        $this->assertEquals(0, $this->object->getLatency('set')->getCount());
+    }
+
+    public function testToMap(): void {
+        $this->object->count(Storage::HITS);
+        $this->object->time('getItem', 0.001);
+
+        $stats = $this->object->toMap();
+
+        $this->assertEquals(1, $stats[Storage::HITS]);
+        $this->assertEquals(1.0, $stats[Storage::HIT_RATIO]);
+        $this->assertEquals(1, $stats['latency.getItem']['count']);
+    }
+
+}
@@ -0,0 +1,22 @@
+<?hh
+namespace Titon\Cache\Serializer;
+
+use Titon\Test\TestCase;
+
+class CompactSerializerTest extends TestCase {
+
+    protected function setUp(): void {
+        if (!function_exists('fb_compact_serialize')) {
+            $this->markTestSkipped('Compact serialization requires HHVM');
+        }
+    }
+
+    public function testSerializeUnserialize(): void {
+        $serializer = new CompactSerializer();
+
+        foreach ([123, 'foo', true, null, ['a' => [1, 2]]] as $value) {
+            $this->assertEquals($value, $serializer->unserialize($serializer->serialize($value)));
+        }
+    }
+
+}
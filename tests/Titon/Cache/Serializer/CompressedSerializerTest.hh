@@ -0,0 +1,54 @@
+<?hh
+namespace Titon\Cache\Serializer;
+
+use Titon\Test\TestCase;
+
+class CompressedSerializerTest extends TestCase {
+
+    public function testBelowThresholdIsNotCompressed(): void {
+        $serializer = new CompressedSerializer(new PhpSerializer(), 1024);
+
+        $this->assertEquals('rs:3:"foo";', $serializer->serialize('foo'));
+        $this->assertEquals('foo', $serializer->unserialize('rs:3:"foo";'));
+    }
+
+    public function testAboveThresholdIsCompressed(): void {
+        $serializer = new CompressedSerializer(new PhpSerializer(), 1024);
+        $value = array_fill(0, 100, 'The quick brown fox jumps over the lazy dog');
+        $raw = serialize($value);
+        $data = $serializer->serialize($value);
+
+        $this->assertNotEquals(CompressedSerializer::RAW, $data[0]);
+        $this->assertLessThan(strlen($raw), strlen($data));
+        $this->assertEquals($value, $serializer->unserialize($data));
+    }
+
+    public function testIncompressibleDataIsNotCompressed(): void {
+        $serializer = new CompressedSerializer(new PhpSerializer(), 0);
+        $data = $serializer->serialize('a');
+
+        $this->assertEquals(CompressedSerializer::RAW, $data[0]);
+        $this->assertEquals('a', $serializer->unserialize($data));
+    }
+
+    /**
+     * @expectedException \Titon\Cache\Exception\CorruptedItemException
+     */
+    public function testCorruptedDataThrows(): void {
+        (new CompressedSerializer(new PhpSerializer()))->unserialize(CompressedSerializer::ZLIB . 'not compressed');
+    }
+
+    /**
+     * @expectedException \Titon\Cache\Exception\CorruptedItemException
+     */
+    public function testUnknownHeaderThrows(): void {
+        (new CompressedSerializer(new PhpSerializer()))->unserialize('s:3:"foo";');
+    }
+
+    public function testReadsZlib(): void {
+        $serializer = new CompressedSerializer(new JsonSerializer());
+
+        $this->assertEquals(['foo' => 'bar'], $serializer->unserialize(CompressedSerializer::ZLIB . gzcompress('{"foo":"bar"}')));
+    }
+
+}
@@ -0,0 +1,22 @@
+<?hh
+namespace Titon\Cache\Serializer;
+
+use Titon\Test\TestCase;
+
+class IgbinarySerializerTest extends TestCase {
+
+    protected function setUp(): void {
+        if (!extension_loaded('igbinary')) {
+            $this->markTestSkipped('igbinary is not installed');
+        }
+    }
+
+    public function testSerializeUnserialize(): void {
+        $serializer = new IgbinarySerializer();
+
+        foreach ([123, 'foo', true, null, ['a' => [1, 2]]] as $value) {
+            $this->assertEquals($value, $serializer->unserialize($serializer->serialize($value)));
+        }
+    }
+
+}
@@ -0,0 +1,18 @@
+<?hh
+namespace Titon\Cache\Serializer;
+
+use Titon\Test\TestCase;
+
+class JsonSerializerTest extends TestCase {
+
+    public function testSerializeUnserialize(): void {
+        $serializer = new JsonSerializer();
+
+        $this->assertEquals('{"foo":[1,2]}', $serializer->serialize(['foo' => [1, 2]]));
+
+        foreach ([123, 'foo', true, null, ['a' => [1, 2]]] as $value) {
+            $this->assertEquals($value, $serializer->unserialize($serializer->serialize($value)));
+        }
+    }
+
+}
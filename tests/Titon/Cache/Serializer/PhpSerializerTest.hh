@@ -0,0 +1,16 @@
+<?hh
+namespace Titon\Cache\Serializer;
+
+use Titon\Test\TestCase;
+
+class PhpSerializerTest extends TestCase {
+
+    public function testSerializeUnserialize(): void {
+        $serializer = new PhpSerializer();
+
+        foreach ([123, 'foo', true, null, ['a' => [1, 2]], Map {'foo' => 'bar'}] as $value) {
+            $this->assertEquals($value, $serializer->unserialize($serializer->serialize($value)));
+        }
+    }
+
+}
@@ -0,0 +1,73 @@
+<?hh
+namespace Titon\Cache\Serializer;
+
+use Titon\Cache\Serializer;
+use Titon\Intl\Catalog;
+use Titon\Test\BenchmarkCase;
+
+class SerializerBenchmark extends BenchmarkCase {
+
+    public function benchCatalog(): void {
+        $messages = Map {};
+
+        for ($i = 0; $i < 2000; $i++) {
+            $messages['module.section_' . $i . '.message'] = sprintf('This is translated message number %s, with a {0} placeholder.', $i);
+        }
+
+        $catalog = new Catalog('default', 'common', $messages);
+
+        $this->compare('Catalog object', $catalog, Map {
+            'php' => new PhpSerializer(),
+            'php+compressed' => new CompressedSerializer(new PhpSerializer())
+        });
+
+        $this->compare('Catalog messages', $messages->toArray(), $this->getSerializers());
+    }
+
+    public function benchSmallValue(): void {
+        $this->compare('Small array', ['id' => 1, 'username' => 'titon', 'active' => true], $this->getSerializers());
+    }
+
+    /**
+     * Measure the encode and decode speed of each serializer, and include the encoded size in the name.
+     */
+    protected function compare(string $name, mixed $value, Map<string, Serializer> $serializers): void {
+        foreach ($serializers as $type => $serializer) {
+            $data = $serializer->serialize($value);
+            $label = sprintf('%s %s (%s bytes)', $name, $type, strlen($data));
+
+            $this->measure($label . ' serialize', 100, () ==> {
+                $serializer->serialize($value);
+            });
+
+            $this->measure($label . ' unserialize', 100, () ==> {
+                $serializer->unserialize($data);
+            });
+        }
+    }
+
+    /**
+     * Return all serializers that are available in the current environment.
+     */
+    protected function getSerializers(): Map<string, Serializer> {
+        $serializers = Map {
+            'php' => new PhpSerializer(),
+            'json' => new JsonSerializer(),
+            'php+compressed' => new CompressedSerializer(new PhpSerializer()),
+            'json+compressed' => new CompressedSerializer(new JsonSerializer())
+        };
+
+        if (function_exists('fb_compact_serialize')) {
+            $serializers['compact'] = new CompactSerializer();
+            $serializers['compact+compressed'] = new CompressedSerializer(new CompactSerializer());
+        }
+
+        if (extension_loaded('igbinary')) {
+            $serializers['igbinary'] = new IgbinarySerializer();
+            $serializers['igbinary+compressed'] = new CompressedSerializer(new IgbinarySerializer());
+        }
+
+        return $serializers;
+    }
+
+}
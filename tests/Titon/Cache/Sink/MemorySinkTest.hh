@@ -0,0 +1,21 @@
+<?hh
+namespace Titon\Cache\Sink;
+
+use Titon\Cache\Metrics;
+use Titon\Test\TestCase;
+
+class MemorySinkTest extends TestCase {
+
+    public function testReport(): void {
+        $sink = new MemorySink();
+        $metrics = (new Metrics())->count('hits', 2);
+
+        $this->assertEquals(null, $sink->getReport('default'));
+
+        $sink->report('default', $metrics);
+
+        $this->assertEquals(Map {'hits' => 2, 'hit.ratio' => 1.0}, $sink->getReport('default'));
+        $this->assertEquals(['default'], $sink->getReports()->keys()->toArray());
+    }
+
+}
@@ -0,0 +1,44 @@
+<?hh
+namespace Titon\Cache\Sink;
+
+use Titon\Cache\Metrics;
+use Titon\Test\TestCase;
+
+class StatsdSinkTest extends TestCase {
+
+    public function testFormat(): void {
+        $sink = new StatsdSink('127.0.0.1', 8125, 'app');
+        $metrics = (new Metrics())->count('hits', 2)->time('getItem', 0.001);
+
+        $this->assertEquals([
+            'app.default.hits:2|c',
+            'app.default.hit.ratio:1.0000|g',
+            'app.default.latency.getItem.count:1|c',
+            'app.default.latency.getItem.mean:1.000|g',
+            'app.default.latency.getItem.max:1.000|g',
+            'app.default.latency.getItem.p50:1.000|g',
+            'app.default.latency.getItem.p95:1.000|g',
+            'app.default.latency.getItem.p99:1.000|g'
+        ], $sink->format('default', $metrics));
+    }
+
+    public function testReport(): void {
+        $errno = 0;
+        $errstr = '';
+        $server = stream_socket_server('udp://127.0.0.1:0', $errno, $errstr, STREAM_SERVER_BIND);
+
+        if (!$server) {
+            $this->markTestSkipped('Could not bind a UDP socket');
+        }
+
+        $port = (int) substr(strrchr(stream_socket_get_name($server, false), ':'), 1);
+
+        $sink = new StatsdSink('127.0.0.1', $port, 'app');
+        $sink->report('default', (new Metrics())->count('hits', 2));
+
+        $this->assertEquals("app.default.hits:2|c\napp.default.hit.ratio:1.0000|g", stream_socket_recvfrom($server, 512));
+
+        fclose($server);
+    }
+
+}
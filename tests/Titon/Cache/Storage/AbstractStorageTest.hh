@@ -3,6 +3,7 @@ namespace Titon\Cache\Storage;
 
 use Titon\Cache\HitItem;
 use Titon\Cache\Item;
+use Titon\Cache\MissItem;
 use Titon\Test\TestCase;
 use Titon\Utility\Config;
 
@@ -57,6 +58,19 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertTrue($this->object->has('qux'));
     }
 
+    public function testCommitDeferredCoalescesKeys(): void {
+        $this->object->saveDeferred(new Item('baz', 1));
+        $this->object->saveDeferred(new Item('baz', 2));
+        $this->object->saveDeferred(new Item('qux', 3, '+5 minutes'));
+        $this->object->saveDeferred(new Item('baz', 4, '+10 minutes'));
+
+        $this->assertTrue($this->object->commit());
+
+        $this->assertEquals(4, $this->object->get('baz'));
+        $this->assertEquals(3, $this->object->get('qux'));
+        $this->assertTrue($this->object->commit()); // Nothing to commit
+    }
+
     public function testDecrement(): void {
         $this->assertEquals(1, $this->object->get('count'));
         $this->assertEquals(0, $this->object->decrement('count', 1));
@@ -94,6 +108,37 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertFalse($this->object->has('foo'));
     }
 
+    public function testGenGet(): void {
+        $this->assertEquals(['username' => 'Titon'], $this->object->genGet('foo')->getWaitHandle()->join());
+    }
+
+    /**
+     * @expectedException \Titon\Cache\Exception\MissingItemException
+     */
+    public function testGenGetMissingKey(): void {
+        $this->object->genGet('bar')->getWaitHandle()->join();
+    }
+
+    public function testGenGetItem(): void {
+        $this->assertEquals(new HitItem('foo', ['username' => 'Titon']), $this->object->genGetItem('foo')->getWaitHandle()->join());
+        $this->assertEquals(new MissItem('bar'), $this->object->genGetItem('bar')->getWaitHandle()->join());
+    }
+
+    public function testGenGetItems(): void {
+        $this->assertEquals(Map {
+            'foo' => new HitItem('foo', ['username' => 'Titon']),
+            'bar' => new MissItem('bar')
+        }, $this->object->genGetItems(['foo', 'bar'])->getWaitHandle()->join());
+    }
+
+    public function testGenSave(): void {
+        $this->assertFalse($this->object->has('baz'));
+
+        $this->object->genSave(new Item('baz', 123, '+5 minutes'))->getWaitHandle()->join();
+
+        $this->assertEquals(123, $this->object->get('baz'));
+    }
+
     public function testGet(): void {
         $this->assertEquals(['username' => 'Titon'], $this->object->get('foo'));
         $this->assertEquals(1, $this->object->get('count'));
@@ -118,6 +163,46 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertFalse($item->isHit());
     }
 
+    public function testGetItemFalsyValue(): void {
+        $this->object->save(new Item('falsy', false));
+
+        $item = $this->object->getItem('falsy');
+
+        $this->assertTrue($item->isHit());
+        $this->assertFalse($item->get());
+    }
+
+    public function testGetItems(): void {
+        $this->assertEquals(Map {
+            'foo' => new HitItem('foo', ['username' => 'Titon']),
+            'bar' => new MissItem('bar'),
+            'count' => new HitItem('count', 1)
+        }, $this->object->getItems(['foo', 'bar', 'count']));
+
+        $this->assertEquals(Map {}, $this->object->getItems([]));
+    }
+
+    public function testGetMany(): void {
+        $this->assertEquals(Map {
+            'foo' => ['username' => 'Titon'],
+            'count' => 1
+        }, $this->object->getMany(['foo', 'bar', 'missing', 'count']));
+
+        $this->assertEquals(Map {}, $this->object->getMany(['bar', 'missing']));
+    }
+
+    public function testGetSetAutoCommit(): void {
+        $this->assertFalse($this->object->isAutoCommit());
+
+        $this->object->setAutoCommit();
+
+        $this->assertTrue($this->object->isAutoCommit());
+
+        $this->object->setAutoCommit(false);
+
+        $this->assertFalse($this->object->isAutoCommit());
+    }
+
     public function testGetSetPrefix(): void {
         $this->assertNotEquals('', $this->object->getPrefix()); // Set in constructor
 
@@ -129,7 +214,14 @@ abstract class AbstractStorageTest extends TestCase {
 
         $this->assertEquals('global-prefix-', $this->object->getPrefix());
 
+        // The resolved prefix is refreshed when either prefix changes
+        $this->object->setPrefix('other-');
+
+        $this->assertEquals('global-other-', $this->object->getPrefix());
+
         Config::set('cache.prefix', '');
+
+        $this->assertEquals('other-', $this->object->getPrefix());
     }
 
     public function testHas(): void {
@@ -143,11 +235,32 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertEquals(7, $this->object->increment('count', 5));
     }
 
+    public function testIncrementIsPersisted(): void {
+        $this->object->increment('count', 5);
+        $this->object->decrement('count', 2);
+
+        $this->assertSame(4, $this->object->get('count'));
+
+        $this->object->increment('counter', 3, 10);
+
+        $this->assertSame(13, $this->object->get('counter'));
+    }
+
     public function testIncrementInitialSet(): void {
         $this->assertSame(1, $this->object->increment('missing'));
         $this->assertSame(6, $this->object->increment('missing', 5));
     }
 
+    public function testLockUnlock(): void {
+        $this->assertTrue($this->object->lock('foo', 10));
+        $this->assertFalse($this->object->lock('foo', 10));
+
+        $this->assertTrue($this->object->unlock('foo'));
+
+        $this->assertTrue($this->object->lock('foo', 10));
+        $this->assertTrue($this->object->unlock('foo'));
+    }
+
     public function testRemove(): void {
         $this->assertTrue($this->object->has('foo'));
 
@@ -164,6 +277,20 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertTrue($this->object->has('bar'));
     }
 
+    public function testSaveMany(): void {
+        $this->object->saveMany(Vector {
+            new Item('baz', 123, '+5 minutes'),
+            new Item('qux', ['a' => 'b'], '+10 minutes'),
+            new Item('expired', true, '-1 day'),
+            new Item('count', 5, '+5 minutes')
+        });
+
+        $this->assertEquals(123, $this->object->get('baz'));
+        $this->assertEquals(['a' => 'b'], $this->object->get('qux'));
+        $this->assertEquals(5, $this->object->get('count'));
+        $this->assertFalse($this->object->has('expired'));
+    }
+
     public function testSaveInvalidExpiration(): void {
         $this->assertFalse($this->object->has('bar'));
 
@@ -180,10 +307,58 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertEquals(['username' => 'Titon Framework'], $this->object->get('foo'));
     }
 
+    public function testSetMany(): void {
+        $this->assertTrue($this->object->setMany(Map {
+            'foo' => ['username' => 'Titon Framework'],
+            'baz' => 123
+        }, strtotime('+10 minutes')));
+
+        $this->assertEquals(['username' => 'Titon Framework'], $this->object->get('foo'));
+        $this->assertEquals(123, $this->object->get('baz'));
+    }
+
     public function testStats(): void {
         $this->assertInstanceOf('HH\Map', $this->object->stats());
     }
 
+    public function testSaveTagged(): void {
+        $this->object->save((new Item('tagged', 'foo', '+5 minutes'))->setTags(['user', 'post']));
+
+        // Tagged items live in the namespace of their tags
+        $this->assertFalse($this->object->has('tagged'));
+        $this->assertEquals('foo', $this->object->tagged(['post', 'user'])->get('tagged'));
+        $this->assertFalse($this->object->tagged(['user'])->has('tagged'));
+
+        $this->object->invalidateTags(['post']);
+
+        $this->assertFalse($this->object->tagged(['post', 'user'])->has('tagged'));
+    }
+
+    public function testSaveManyTagged(): void {
+        $this->object->saveMany(Vector {
+            (new Item('a', 1, '+5 minutes'))->setTags(['user']),
+            (new Item('b', 2, '+5 minutes'))->setTags(['user']),
+            new Item('c', 3, '+5 minutes')
+        });
+
+        $this->assertEquals(Map {'a' => 1, 'b' => 2}, $this->object->tagged(['user'])->getMany(['a', 'b', 'c']));
+        $this->assertEquals(3, $this->object->get('c'));
+    }
+
+    public function testTagged(): void {
+        $tagged = $this->object->tagged(['user']);
+        $tagged->set('foo', 'bar', time() + 300);
+
+        $this->assertEquals('bar', $tagged->get('foo'));
+        $this->assertEquals(['username' => 'Titon'], $this->object->get('foo'));
+
+        // Flushing a tagged view only invalidates its tags
+        $tagged->flush();
+
+        $this->assertFalse($tagged->has('foo'));
+        $this->assertTrue($this->object->has('foo'));
+    }
+
     public function testStore(): void {
         $this->assertEquals('foo', $this->object->store('storeTest', () ==> 'foo'));
 
@@ -192,4 +367,53 @@ abstract class AbstractStorageTest extends TestCase {
         $this->assertEquals('foo', $this->object->store('storeTest', () ==> 'baz'));
     }
 
+    public function testStoreEarlyExpiration(): void {
+        $this->object->setMany(Map {
+            'early' => 'old',
+            'early.meta' => shape('delta' => 1000000.0, 'expires' => time() + 60)
+        }, time() + 60);
+
+        $this->assertEquals('old', $this->object->store('early', () ==> 'new', '+5 minutes'));
+        $this->assertEquals('new', $this->object->store('early', () ==> 'new', '+5 minutes', Map {'beta' => 1000.0}));
+    }
+
+    public function testStoreServesStaleWhileLocked(): void {
+        $this->object->setMany(Map {
+            'stale' => 'old',
+            'stale.meta' => shape('delta' => 0.1, 'expires' => time() - 1)
+        }, time() + 60);
+
+        $options = Map {'lock' => 10, 'stale' => 60};
+
+        $this->object->lock('stale', 10);
+
+        $this->assertEquals('old', $this->object->store('stale', () ==> 'new', '+5 minutes', $options));
+
+        $this->object->unlock('stale');
+
+        $this->assertEquals('new', $this->object->store('stale', () ==> 'new', '+5 minutes', $options));
+        $this->assertEquals('new', $this->object->get('stale'));
+    }
+
+    public function testStoreWaitsForLock(): void {
+        $this->object->lock('stampede', 10);
+
+        // Lock is held elsewhere and the value never appears, so compute anyway
+        $this->assertEquals('foo', $this->object->store('stampede', () ==> 'foo', '+5 minutes', Map {'lock' => 10, 'wait' => 20}));
+
+        $this->object->unlock('stampede');
+    }
+
+    public function testStoreWithLock(): void {
+        $options = Map {'lock' => 10};
+
+        $this->assertEquals('foo', $this->object->store('stampede', () ==> 'foo', '+5 minutes', $options));
+        $this->assertEquals('foo', $this->object->store('stampede', () ==> 'bar', '+5 minutes', $options));
+
+        // Lock is released after recomputing
+        $this->assertTrue($this->object->lock('stampede', 10));
+
+        $this->object->unlock('stampede');
+    }
+
 }
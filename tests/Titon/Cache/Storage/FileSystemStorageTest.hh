@@ -1,6 +1,9 @@
 <?hh
 namespace Titon\Cache\Storage;
 
+use Titon\Cache\Serializer\CompressedSerializer;
+use Titon\Cache\Serializer\JsonSerializer;
+
 class FileSystemStorageTest extends AbstractStorageTest {
 
     protected function setUp(): void {
@@ -18,22 +21,141 @@ class FileSystemStorageTest extends AbstractStorageTest {
         new FileSystemStorage('');
     }
 
+    public function testFilesAreSharded(): void {
+        $this->assertFileExists($this->getCachePath('foo'));
+        $this->assertFileExists($this->getCachePath('count'));
+    }
+
+    public function testDistinctKeysDoNotCollide(): void {
+        $this->object->set('foo.bar', 1, time() + 300);
+        $this->object->set('foo-bar', 2, time() + 300);
+
+        $this->assertEquals(1, $this->object->get('foo.bar'));
+        $this->assertEquals(2, $this->object->get('foo-bar'));
+    }
+
+    public function testExpirationHeader(): void {
+        $this->object->set('header', 'foo', 1234567890);
+
+        $this->assertEquals("1234567890\n" . serialize('foo'), file_get_contents($this->getCachePath('header')));
+        $this->assertFalse($this->object->has('header'));
+        $this->assertFileNotExists($this->getCachePath('header'));
+    }
+
     public function testFlush(): void {
-        $this->assertFileExists($this->vfs()->path('/cache/fs-foo.cache'));
+        $path = $this->getCachePath('foo');
+
+        $this->assertEquals(0, $this->object->getGeneration());
+
+        $this->object->flush();
+
+        $this->assertEquals(1, $this->object->getGeneration());
+        $this->assertFalse($this->object->has('foo'));
+        $this->assertFileExists($path); // Not deleted until purged
+
+        // Other instances pick up the new generation
+        $this->assertEquals(1, (new FileSystemStorage($this->vfs()->path('/cache/'), 'fs-'))->getGeneration());
+    }
+
+    public function testPurge(): void {
+        $path = $this->getCachePath('foo');
+
+        $this->object->flush();
+        $this->object->set('fresh', 'foo', time() + 300);
+        $this->object->set('expired', 'foo', time() - 300);
+
+        $this->object->purge();
+
+        $this->assertFileNotExists($path);
+        $this->assertFileNotExists($this->getCachePath('expired'));
+        $this->assertFileExists($this->getCachePath('fresh'));
+        $this->assertEquals('foo', $this->object->get('fresh'));
+    }
+
+    public function testIncrementWhileLocked(): void {
+        $this->assertTrue($this->object->lock('count', 60));
+
+        $this->assertEquals(2, $this->object->increment('count'));
+        $this->assertFileExists($this->getLockPath('count', 'mutex'));
+
+        $this->assertTrue($this->object->unlock('count'));
+    }
+
+    public function testExpiredReadsDoNotCreateLockFiles(): void {
+        $this->object->set('expired', 'foo', time() - 60);
+
+        $this->assertFalse($this->object->has('expired'));
+        $this->assertFileNotExists($this->getCachePath('expired'));
+        $this->assertFileNotExists(dirname($this->getLockPath('expired', 'mutex')));
+    }
 
+    public function testPurgeRemovesLockFilesThatAreNotHeld(): void {
+        $this->assertTrue($this->object->lock('held', 60));
+        $this->assertTrue($this->object->lock('released', 60));
+        $this->assertTrue($this->object->unlock('released'));
+
+        $this->assertFileExists($this->getLockPath('held'));
+        $this->assertFileExists($this->getLockPath('released'));
+
+        // Locks do not belong to a generation
         $this->object->flush();
 
-        $this->assertFileNotExists($this->vfs()->path('/cache/fs-foo.cache'));
+        $this->assertFalse($this->object->lock('held', 60));
+
+        $this->object->purge();
+
+        $this->assertFileExists($this->getLockPath('held'));
+        $this->assertFileNotExists($this->getLockPath('released'));
+
+        // The lock file is re-created when needed
+        $this->assertTrue($this->object->lock('released', 60));
+        $this->assertFileExists($this->getLockPath('released'));
     }
 
     public function testRemove(): void {
         $this->assertTrue($this->object->has('foo'));
-        $this->assertFileExists($this->vfs()->path('/cache/fs-foo.cache'));
+        $this->assertFileExists($this->getCachePath('foo'));
 
         $this->object->remove('foo');
 
         $this->assertFalse($this->object->has('foo'));
-        $this->assertFileNotExists($this->vfs()->path('/cache/fs-foo.cache'));
+        $this->assertFileNotExists($this->getCachePath('foo'));
+    }
+
+    public function testSerializer(): void {
+        $this->assertInstanceOf('Titon\Cache\Serializer\PhpSerializer', $this->object->getSerializer());
+
+        $this->object->setSerializer(new JsonSerializer());
+        $this->object->set('json', ['foo' => 'bar'], time() + 300);
+
+        $this->assertStringEndsWith("\n" . '{"foo":"bar"}', file_get_contents($this->getCachePath('json')));
+        $this->assertEquals(['foo' => 'bar'], $this->object->get('json'));
+
+        $value = array_fill(0, 100, 'The quick brown fox jumps over the lazy dog');
+
+        $this->object->setSerializer(new CompressedSerializer(new JsonSerializer(), 100));
+        $this->object->set('compressed', $value, time() + 300);
+
+        $this->assertEquals($value, $this->object->get('compressed'));
+        $this->assertLessThan(strlen(json_encode($value)), filesize($this->getCachePath('compressed')));
+    }
+
+    public function testWritesDoNotLeaveTempFiles(): void {
+        $this->object->set('atomic', 'foo', time() + 300);
+
+        $this->assertEquals([basename($this->getCachePath('atomic'))], array_values(array_diff(scandir(dirname($this->getCachePath('atomic'))), ['.', '..'])));
+    }
+
+    protected function getLockPath(string $key, string $ext = 'lock'): string {
+        $hash = md5('fs-' . $key);
+
+        return $this->vfs()->path(sprintf('/cache/locks/%s/%s/%s.%s', substr($hash, 0, 2), substr($hash, 2, 2), $hash, $ext));
+    }
+
+    protected function getCachePath(string $key): string {
+        $hash = md5('fs-' . $key);
+
+        return $this->vfs()->path(sprintf('/cache/%s/%s/%s/%s.cache', $this->object->getGeneration(), substr($hash, 0, 2), substr($hash, 2, 2), $hash));
     }
 
 }
@@ -0,0 +1,87 @@
+<?hh
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\Item;
+use Titon\Cache\Sink\MemorySink;
+
+class InstrumentedStorageTest extends AbstractStorageTest {
+
+    protected MemorySink $sink;
+
+    protected function setUp(): void {
+        $this->sink = new MemorySink();
+        $this->object = new InstrumentedStorage(new MemoryStorage('instrumented-'), $this->sink, 'memory', true);
+
+        parent::setUp();
+    }
+
+    public function testCountsHitsAndMisses(): void {
+        $metrics = $this->object->getMetrics();
+        $metrics->reset();
+
+        $this->object->getItem('foo');
+        $this->object->getItem('missing');
+        $this->object->getMany(['foo', 'count', 'missing']);
+
+        $this->assertEquals(3, $metrics->getCounter('hits'));
+        $this->assertEquals(2, $metrics->getCounter('misses'));
+        $this->assertEquals(0.6, $metrics->getHitRatio());
+        $this->assertEquals(strlen(serialize(['username' => 'Titon'])) * 2 + strlen(serialize(1)), $metrics->getCounter('bytes.read'));
+        $this->assertEquals(2, $metrics->getLatency('getItem')->getCount());
+        $this->assertEquals(1, $metrics->getLatency('getMany')->getCount());
+    }
+
+    public function testCountsSets(): void {
+        $metrics = $this->object->getMetrics();
+        $metrics->reset();
+
+        $this->object->save(new Item('baz', 'qux', '+5 minutes'));
+
+        $this->assertEquals(1, $metrics->getCounter('sets'));
+        $this->assertEquals(strlen(serialize('qux')), $metrics->getCounter('bytes.written'));
+        $this->assertEquals(1, $metrics->getLatency('set')->getCount());
+    }
+
+    public function testBytesAreNotCountedByDefault(): void {
+        $storage = new InstrumentedStorage(new MemoryStorage());
+        $storage->set('foo', 'bar', time() + 300);
+        $storage->get('foo');
+
+        $this->assertEquals(1, $storage->getMetrics()->getCounter('sets'));
+        $this->assertEquals(1, $storage->getMetrics()->getCounter('hits'));
+        $this->assertEquals(0, $storage->getMetrics()->getCounter('bytes.written'));
+        $this->assertEquals(0, $storage->getMetrics()->getCounter('bytes.read'));
+    }
+
+    public function testPrefixIsDelegated(): void {
+        $this->assertEquals('instrumented-', $this->object->getStorage()->getPrefix());
+
+        $this->object->setPrefix('other-');
+
+        $this->assertEquals('other-', $this->object->getStorage()->getPrefix());
+    }
+
+    public function testReport(): void {
+        $this->object->getItem('foo');
+        $this->object->report();
+
+        $report = $this->sink->getReport('memory');
+
+        $this->assertTrue($report['hits'] > 0);
+        $this->assertTrue($report->contains('latency.getItem'));
+
+        // Metrics are reset once reported
+        $this->assertEquals(Map {}, $this->object->getMetrics()->getCounters());
+    }
+
+    public function testStatsIncludeMetrics(): void {
+        $this->object->getItem('foo');
+
+        $stats = $this->object->stats();
+
+        $this->assertTrue($stats->contains('items')); // From the memory storage
+        $this->assertTrue($stats->contains('hit.ratio'));
+        $this->assertTrue($stats->contains('latency.getItem'));
+    }
+
+}
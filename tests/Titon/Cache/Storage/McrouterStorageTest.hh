@@ -0,0 +1,28 @@
+<?hh
+namespace Titon\Cache\Storage;
+
+use \MCRouter;
+use \MCRouterException;
+
+class McrouterStorageTest extends AbstractStorageTest {
+
+    protected function setUp(): void {
+        if (!class_exists('MCRouter')) {
+            $this->markTestSkipped('Mcrouter is not available in this HHVM build');
+        }
+
+        $mcrouter = MCRouter::createSimple(Vector {'127.0.0.1:11211'});
+
+        // Check that mcrouter connected
+        try {
+            $mcrouter->genVersion()->getWaitHandle()->join();
+        } catch (MCRouterException $e) {
+            $this->markTestSkipped('Could not connect to Memcache');
+        }
+
+        $this->object = new McrouterStorage($mcrouter, 'mcrouter-');
+
+        parent::setUp();
+    }
+
+}
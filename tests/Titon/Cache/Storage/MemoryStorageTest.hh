@@ -1,6 +1,8 @@
 <?hh
 namespace Titon\Cache\Storage;
 
+use Titon\Cache\Storage;
+
 class MemoryStorageTest extends AbstractStorageTest {
 
     protected function setUp(): void {
@@ -9,4 +11,81 @@ class MemoryStorageTest extends AbstractStorageTest {
         parent::setUp();
     }
 
+    public function testExpiredItemsAreRemoved(): void {
+        $this->object->set('expired', 'foo', time() - 1);
+
+        $this->assertFalse($this->object->has('expired'));
+        $this->assertEquals(null, $this->object->getCache('memory-expired'));
+    }
+
+    public function testZeroExpirationNeverExpires(): void {
+        $this->object->set('forever', 'foo', 0);
+
+        $this->assertTrue($this->object->has('forever'));
+        $this->assertEquals('foo', $this->object->get('forever'));
+
+        $storage = new MemoryStorage('', 2);
+        $storage->set('a', 1, 0);
+        $storage->set('b', 2, time() - 1);
+        $storage->set('c', 3, time() + 60);
+
+        // Expired items are evicted first, while items without an expiration are kept
+        $this->assertTrue($storage->has('a'));
+        $this->assertEquals(0, $storage->stats()[Storage::EVICTIONS]);
+    }
+
+    public function testMaxItemsEvictsLeastRecentlyUsed(): void {
+        $storage = new MemoryStorage('', 2);
+        $storage->set('a', 1, time() + 60);
+        $storage->set('b', 2, time() + 60);
+
+        // Mark as recently used
+        $storage->get('a');
+
+        $storage->set('c', 3, time() + 60);
+
+        $this->assertTrue($storage->has('a'));
+        $this->assertFalse($storage->has('b'));
+        $this->assertTrue($storage->has('c'));
+        $this->assertEquals(1, $storage->stats()[Storage::EVICTIONS]);
+    }
+
+    public function testMaxItemsEvictsExpiredFirst(): void {
+        $storage = new MemoryStorage('', 2);
+        $storage->set('a', 1, time() + 60);
+        $storage->set('b', 2, time() - 1);
+        $storage->set('c', 3, time() + 60);
+
+        $this->assertTrue($storage->has('a'));
+        $this->assertTrue($storage->has('c'));
+        $this->assertEquals(0, $storage->stats()[Storage::EVICTIONS]);
+    }
+
+    public function testMaxBytes(): void {
+        $storage = new MemoryStorage('', 0, 30);
+        $storage->set('a', 'abcdefghij', time() + 60); // s:10:"abcdefghij"; = 18 bytes
+        $storage->set('b', 'abcdefghij', time() + 60);
+
+        $this->assertFalse($storage->has('a'));
+        $this->assertTrue($storage->has('b'));
+        $this->assertEquals(18, $storage->stats()[Storage::MEMORY_USAGE]);
+        $this->assertEquals(12, $storage->stats()[Storage::MEMORY_AVAILABLE]);
+
+        // Larger than the budget
+        $this->assertFalse($storage->set('c', str_repeat('a', 50), time() + 60));
+        $this->assertFalse($storage->has('c'));
+    }
+
+    public function testStatsCounters(): void {
+        $this->object->get('foo');
+        $this->object->getItem('missing');
+
+        $stats = $this->object->stats();
+
+        $this->assertEquals(1, $stats[Storage::HITS]);
+        $this->assertEquals(1, $stats[Storage::MISSES]);
+        $this->assertEquals(2, $stats[Storage::ITEMS]);
+        $this->assertEquals(false, $stats[Storage::MEMORY_AVAILABLE]);
+    }
+
 }
@@ -0,0 +1,180 @@
+<?hh
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\Exception\CorruptedItemException;
+use Titon\Cache\Storage;
+use Titon\Test\Stub\Cache\FailingStorageStub;
+
+/**
+ * @property \Titon\Cache\Storage\ShardedStorage $object
+ */
+class ShardedStorageTest extends AbstractStorageTest {
+
+    protected Map<string, FailingStorageStub> $nodes = Map {};
+
+    protected function setUp(): void {
+        $this->nodes = Map {
+            'a' => new FailingStorageStub(),
+            'b' => new FailingStorageStub(),
+            'c' => new FailingStorageStub()
+        };
+
+        $this->object = new ShardedStorage($this->nodes->toMap(), 160, 30, 'sharded-');
+
+        parent::setUp();
+    }
+
+    public function testAddingNodeOnlyRemapsAFraction(): void {
+        $keys = $this->generateKeys(1000);
+        $before = Map {};
+
+        foreach ($keys as $key) {
+            $before[$key] = $this->object->getNodeName($key);
+        }
+
+        $this->object->addNode('d', new MemoryStorage());
+
+        $moved = 0;
+
+        foreach ($keys as $key) {
+            $name = $this->object->getNodeName($key);
+
+            if ($name !== $before[$key]) {
+                $this->assertEquals('d', $name); // Keys only move to the new node
+                $moved++;
+            }
+        }
+
+        // Roughly a quarter of the keys should move
+        $this->assertTrue($moved > 150 && $moved < 400);
+    }
+
+    public function testDistributesKeysOverNodes(): void {
+        $counts = $this->countNodes($this->generateKeys(3000));
+
+        foreach (['a', 'b', 'c'] as $name) {
+            $this->assertTrue($counts[$name] > 600 && $counts[$name] < 1400);
+        }
+    }
+
+    public function testGetManyGroupsByNode(): void {
+        $this->object->set('x', 1, time() + 300);
+        $this->object->set('y', 2, time() + 300);
+        $this->object->set('z', 3, time() + 300);
+
+        $this->assertEquals(Map {'x' => 1, 'y' => 2, 'z' => 3}, $this->object->getMany(['x', 'y', 'z', 'missing']));
+
+        // Each item lives on a single node
+        foreach (['x', 'y', 'z'] as $key) {
+            $this->assertTrue($this->object->getNode($key)->has('sharded-' . $key));
+        }
+    }
+
+    public function testNodeFailureRemapsKeys(): void {
+        $name = $this->object->getNodeName('sharded-foo');
+
+        $this->nodes[$name]->down = true;
+
+        // Miss on the remapped node instead of an exception
+        $this->assertFalse($this->object->has('foo'));
+        $this->assertFalse($this->object->isAvailable($name));
+        $this->assertNotEquals($name, $this->object->getNodeName('sharded-foo'));
+
+        $this->object->set('foo', 'bar', time() + 300);
+
+        $this->assertEquals('bar', $this->object->get('foo'));
+    }
+
+    public function testItemErrorsDoNotFailNodes(): void {
+        $name = $this->object->getNodeName('sharded-foo');
+
+        $this->nodes[$name]->corrupted = true;
+
+        try {
+            $this->object->getItem('foo');
+            $this->fail('CorruptedItemException was not thrown');
+        } catch (CorruptedItemException $e) {
+            // Rethrown
+        }
+
+        $this->assertTrue($this->object->isAvailable($name));
+        $this->assertEquals($name, $this->object->getNodeName('sharded-foo'));
+    }
+
+    public function testGetManyRemapsFailedNodes(): void {
+        $this->object->set('x', 1, time() + 300);
+
+        $name = $this->object->getNodeName('sharded-x');
+
+        $this->nodes[$name]->down = true;
+
+        // Missing on the remapped node
+        $this->assertEquals(Map {}, $this->object->getMany(['x']));
+        $this->assertFalse($this->object->isAvailable($name));
+    }
+
+    /**
+     * @expectedException \Titon\Cache\Exception\MissingStorageException
+     */
+    public function testNoAvailableNodes(): void {
+        foreach ($this->nodes->keys() as $name) {
+            $this->object->markFailed($name);
+        }
+
+        $this->object->getNodeName('foo');
+    }
+
+    public function testRemoveNode(): void {
+        $this->object->removeNode('a');
+
+        $counts = $this->countNodes($this->generateKeys(100));
+
+        $this->assertFalse($counts->contains('a'));
+        $this->assertEquals(['b', 'c'], $this->object->getNodes()->keys()->toArray());
+    }
+
+    public function testStatsCalculateHitRatio(): void {
+        foreach (['a', 'b', 'c'] as $i => $name) {
+            $this->nodes[$name]->setMany(Map {'key' => $i}, time() + 300);
+        }
+
+        // Ratios of 1, 0.5, and 0 would sum to more than 1
+        $this->nodes['a']->get('key');
+        $this->nodes['a']->get('key');
+        $this->nodes['b']->get('key');
+        $this->nodes['b']->getItem('missing');
+        $this->nodes['c']->getItem('missing');
+
+        $stats = $this->object->stats();
+        $hits = $stats[Storage::HITS];
+        $misses = $stats[Storage::MISSES];
+
+        $this->assertEquals(round($hits / ($hits + $misses), 4), $stats[Storage::HIT_RATIO]);
+        $this->assertLessThanOrEqual(1, $stats[Storage::HIT_RATIO]);
+    }
+
+    public function testWeights(): void {
+        $this->object->addNode('c', $this->nodes['c'], 2);
+
+        $counts = $this->countNodes($this->generateKeys(4000));
+
+        // Node c has half of the total weight
+        $this->assertTrue($counts['c'] > 1800 && $counts['c'] < 2600);
+    }
+
+    protected function countNodes(array<string> $keys): Map<string, int> {
+        $counts = Map {};
+
+        foreach ($keys as $key) {
+            $name = $this->object->getNodeName($key);
+            $counts[$name] = ($counts->get($name) ?: 0) + 1;
+        }
+
+        return $counts;
+    }
+
+    protected function generateKeys(int $count): array<string> {
+        return array_map($i ==> 'key.' . $i, range(1, $count));
+    }
+
+}
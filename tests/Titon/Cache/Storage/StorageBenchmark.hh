@@ -0,0 +1,98 @@
+<?hh
+namespace Titon\Cache\Storage;
+
+use Titon\Cache\Item;
+use Titon\Cache\Storage;
+use Titon\Io\Folder;
+use Titon\Test\BenchmarkCase;
+use Titon\Utility\Config;
+
+class StorageBenchmark extends BenchmarkCase {
+
+    protected string $path = '';
+
+    public function setUp(): void {
+        $this->path = TEMP_DIR . '/cache-benchmark/';
+    }
+
+    public function tearDown(): void {
+        (new Folder($this->path))->delete();
+    }
+
+    public function benchFileSystem(): void {
+        $this->compareFetches('FileSystemStorage', new FileSystemStorage($this->path, 'bench-'));
+    }
+
+    public function benchMemory(): void {
+        $this->compareFetches('MemoryStorage', new MemoryStorage('bench-'));
+    }
+
+    /**
+     * Measure the overhead of each operation on the memory storage, where the backend itself is cheap
+     * and the cost is dominated by key resolution.
+     */
+    public function benchMemoryOperations(): void {
+        $storage = new MemoryStorage('bench-');
+        $keys = array_map($i ==> 'key' . $i, range(1, 100));
+
+        Config::set('cache.prefix', 'app-');
+
+        $this->measure('Config::get() (cache.prefix)', 10000, () ==> {
+            Config::get('cache.prefix', '');
+        });
+
+        $this->measure('MemoryStorage getPrefix()', 10000, () ==> {
+            $storage->getPrefix();
+        });
+
+        $this->measure('MemoryStorage set()', 10000, () ==> {
+            $storage->set('foo', 'bar', time() + 300);
+        });
+
+        $this->measure('MemoryStorage has()', 10000, () ==> {
+            $storage->has('foo');
+        });
+
+        $this->measure('MemoryStorage getItem()', 10000, () ==> {
+            $storage->getItem('foo');
+        });
+
+        $this->measure('MemoryStorage remove()', 10000, () ==> {
+            $storage->remove('foo');
+        });
+
+        $this->measure('MemoryStorage store() (hit)', 10000, () ==> {
+            $storage->store('stored', () ==> 'bar');
+        });
+
+        $this->measure('MemoryStorage getMany() (100 keys)', 100, () ==> {
+            $storage->getMany($keys);
+        });
+
+        Config::set('cache.prefix', '');
+    }
+
+    /**
+     * Compare the previous has() then get() double lookup against a single getItem() fetch, for both hits and misses.
+     */
+    protected function compareFetches(string $name, Storage $storage): void {
+        $storage->save(new Item('hit', ['id' => 1, 'name' => 'Titon'], '+1 hour'));
+
+        foreach (['hit', 'miss'] as $key) {
+            $this->measure(sprintf('%s has() + get() (%s)', $name, $key), 1000, () ==> {
+                if ($storage->has($key)) {
+                    $storage->get($key);
+                }
+            });
+
+            $this->measure(sprintf('%s getItem() (%s)', $name, $key), 1000, () ==> {
+                $storage->getItem($key)->get();
+            });
+        }
+
+        $this->measure(sprintf('%s store() (hit)', $name), 1000, () ==> {
+            $storage->store('hit', () ==> null);
+        });
+    }
+
+}
@@ -0,0 +1,127 @@
+<?hh
+namespace Titon\Cache\Storage;
+
+class TieredStorageTest extends AbstractStorageTest {
+
+    protected MemoryStorage $l1;
+
+    protected MemoryStorage $l2;
+
+    protected function setUp(): void {
+        $this->l1 = new MemoryStorage('l1-');
+        $this->l2 = new MemoryStorage('l2-');
+        $this->object = new TieredStorage($this->l2, $this->l1, 60, 60, 'tiered-');
+
+        parent::setUp();
+    }
+
+    public function testGetItemReadsThroughToL1(): void {
+        $this->l2->set('tiered-shared', 'foo', time() + 300);
+
+        $this->assertFalse($this->l1->has($this->getL1Key('shared')));
+
+        $this->assertEquals('foo', $this->object->get('shared'));
+
+        $this->assertTrue($this->l1->has($this->getL1Key('shared')));
+
+        // Served from L1 without hitting L2
+        $hits = $this->l2->stats()['hits'];
+
+        $this->assertEquals('foo', $this->object->get('shared'));
+        $this->assertEquals($hits, $this->l2->stats()['hits']);
+    }
+
+    public function testGetManyReadsThroughToL1(): void {
+        $this->l2->set('tiered-shared', 'foo', time() + 300);
+
+        $this->assertEquals(Map {'foo' => ['username' => 'Titon'], 'shared' => 'foo'}, $this->object->getMany(['foo', 'shared', 'missing']));
+
+        $this->assertTrue($this->l1->has($this->getL1Key('shared')));
+    }
+
+    public function testMissesAreCached(): void {
+        $this->assertFalse($this->object->getItem('negative')->isHit());
+
+        // Written to L2 by another process
+        $this->l2->set('tiered-negative', 'foo', time() + 300);
+
+        $this->assertFalse($this->object->getItem('negative')->isHit());
+        $this->assertFalse($this->object->has('negative'));
+
+        // Writing through this storage clears the miss
+        $this->object->set('negative', 'bar', time() + 300);
+
+        $this->assertEquals('bar', $this->object->get('negative'));
+    }
+
+    public function testMissesAreBounded(): void {
+        for ($i = 0; $i <= TieredStorage::MAX_MISSES; $i++) {
+            $this->object->getItem('missing-' . $i);
+        }
+
+        $this->l2->set('tiered-missing-0', 'foo', time() + 300);
+        $this->l2->set('tiered-missing-1', 'bar', time() + 300);
+
+        // The oldest miss was forgotten
+        $this->assertEquals('foo', $this->object->get('missing-0'));
+        $this->assertFalse($this->object->getItem('missing-1')->isHit());
+    }
+
+    public function testRemoveFansOut(): void {
+        $l1Key = $this->getL1Key('foo');
+
+        $this->assertTrue($this->l1->has($l1Key));
+        $this->assertTrue($this->l2->has('tiered-foo'));
+
+        $this->object->remove('foo');
+
+        $this->assertFalse($this->l1->has($l1Key));
+        $this->assertFalse($this->l2->has('tiered-foo'));
+    }
+
+    public function testRemoveInvalidatesL1OfOtherProcesses(): void {
+        $this->l2->set('tiered-shared', 'foo', time() + 300);
+
+        // Another host, with its own L1
+        $other = new TieredStorage($this->l2, new MemoryStorage('other-'), 60, 0, 'tiered-');
+
+        $this->assertEquals('foo', $this->object->get('shared'));
+
+        $other->remove('shared');
+
+        // The next request on this host
+        $next = new TieredStorage($this->l2, $this->l1, 60, 0, 'tiered-');
+
+        $this->assertNotEquals($this->object->getGeneration(), $next->getGeneration());
+        $this->assertTrue($this->l1->has($this->getL1Key('shared')));
+        $this->assertFalse($next->getItem('shared')->isHit());
+    }
+
+    public function testFlushInvalidatesL1OfOtherProcesses(): void {
+        $other = new TieredStorage($this->l2, new MemoryStorage('other-'), 60, 0, 'tiered-');
+
+        $this->assertEquals($this->object->getGeneration(), $other->getGeneration());
+
+        $other->flush();
+
+        $next = new TieredStorage($this->l2, $this->l1, 60, 0, 'tiered-');
+
+        $this->assertEquals($other->getGeneration(), $next->getGeneration());
+        $this->assertTrue($this->l1->has($this->getL1Key('foo')));
+        $this->assertFalse($next->has('foo'));
+    }
+
+    public function testSetWritesThrough(): void {
+        $this->object->set('through', 'foo', time() + 300);
+
+        $this->assertEquals('foo', $this->l1->get($this->getL1Key('through')));
+        $this->assertEquals('foo', $this->l2->get('tiered-through'));
+    }
+
+    protected function getL1Key(string $key): string {
+        invariant($this->object instanceof TieredStorage, 'Must be a TieredStorage.');
+
+        return $this->object->getGeneration() . ':tiered-' . $key;
+    }
+
+}
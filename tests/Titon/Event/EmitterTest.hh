@@ -66,6 +66,42 @@ class EmitterTest extends TestCase {
         }, $this->object->getCallStack('event.test'));
     }
 
+    public function testCompiledObserversAreRebuiltOnChange(): void {
+        $ob1 = inst_meth(new ListenerStub(), 'noop1');
+        $ob2 = inst_meth(new ListenerStub(), 'noop2');
+
+        $this->object->subscribe('event.test', $ob1, 20);
+        $this->object->emit(new Event('event.test'));
+
+        $this->assertEquals(Vector {'Titon\Test\Stub\Event\ListenerStub::noop1'}, $this->object->getCallStack('event.test'));
+
+        $this->object->subscribe('event.test', $ob2, 10);
+
+        $this->assertEquals(Vector {
+            'Titon\Test\Stub\Event\ListenerStub::noop2',
+            'Titon\Test\Stub\Event\ListenerStub::noop1'
+        }, $this->object->emit(new Event('event.test'))->getCallStack());
+
+        $this->object->unsubscribe('event.test', $ob2);
+
+        $this->assertEquals(Vector {'Titon\Test\Stub\Event\ListenerStub::noop1'}, $this->object->getCallStack('event.test'));
+
+        $this->object->flush('event.test');
+
+        $this->assertEquals(Vector {}, $this->object->getCallStack('event.test'));
+    }
+
+    public function testEmitCallStackIsSnapshot(): void {
+        $this->object->subscribe('event.test', inst_meth(new ListenerStub(), 'noop1'));
+
+        $event = $this->object->emit(new Event('event.test'));
+
+        // Observers subscribed after the emit are not part of the call stack
+        $this->object->subscribe('event.test', inst_meth(new ListenerStub(), 'noop2'));
+
+        $this->assertEquals(Vector {'Titon\Test\Stub\Event\ListenerStub::noop1'}, $event->getCallStack());
+    }
+
     public function testGetEventKeys(): void {
         $this->assertEquals(Vector {}, $this->object->getEventKeys());
 
@@ -174,6 +210,25 @@ class EmitterTest extends TestCase {
         }, $this->object->getObservers('event.test'));
     }
 
+    public function testUnsubscribeRemovesEveryMatchingObserver(): void {
+        $ob1 = ($event) ==> { };
+        $ob2 = ($event) ==> { };
+        $ob3 = ($event) ==> { };
+
+        $this->object->subscribe('event.test', $ob1);
+        $this->object->subscribe('event.test', $ob2);
+        $this->object->subscribe('event.test', $ob1);
+        $this->object->subscribe('event.test', $ob3);
+
+        // Removing the first index shifts the second, so other observers must not be removed
+        $this->object->unsubscribe('event.test', $ob1);
+
+        $this->assertEquals(Vector {
+            new Observer($ob2, 101, false),
+            new Observer($ob3, 103, false)
+        }, $this->object->getObservers('event.test'));
+    }
+
     public function testListenAndUnlisten(): void {
         $listener = new ListenerStub();
 
@@ -30,6 +30,21 @@ class EventTest extends TestCase {
         }, $this->object->getCallStack());
     }
 
+    public function testGetCallStackFromLoader(): void {
+        $calls = Vector {};
+
+        $this->object->setCallStackLoader(() ==> {
+            $calls[] = true;
+
+            return Vector {'ClassName::method1'};
+        });
+
+        $this->assertEquals(0, count($calls));
+        $this->assertEquals(Vector {'ClassName::method1'}, $this->object->getCallStack());
+        $this->assertEquals(Vector {'ClassName::method1'}, $this->object->getCallStack());
+        $this->assertEquals(1, count($calls));
+    }
+
     public function testGetIndexAndNext(): void {
         $this->assertEquals(0, $this->object->getIndex());
 
@@ -0,0 +1,55 @@
+<?hh
+namespace Titon\Route;
+
+use Titon\Test\TestCase;
+
+/**
+ * @property \Titon\Route\MatchCache $object
+ */
+class MatchCacheTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->object = new MatchCache(2);
+    }
+
+    public function testGetAndSet(): void {
+        $result = shape('key' => 'module', 'url' => '/users', 'params' => ['module' => 'users']);
+
+        $this->assertEquals(null, $this->object->get('get http://localhost/users'));
+
+        $this->object->set('get http://localhost/users', $result);
+
+        $this->assertEquals($result, $this->object->get('get http://localhost/users'));
+        $this->assertEquals(1, $this->object->getHits());
+        $this->assertEquals(1, $this->object->getMisses());
+        $this->assertEquals(0.5, $this->object->getHitRatio());
+    }
+
+    public function testEvictsLeastRecentlyUsed(): void {
+        $this->object->set('a', shape('key' => 'a', 'url' => '/a', 'params' => []));
+        $this->object->set('b', shape('key' => 'b', 'url' => '/b', 'params' => []));
+
+        // Mark as recently used
+        $this->object->get('a');
+
+        $this->object->set('c', shape('key' => 'c', 'url' => '/c', 'params' => []));
+
+        $this->assertEquals(Vector {'a', 'c'}, $this->object->getResults()->keys());
+    }
+
+    public function testFlush(): void {
+        $this->object->set('a', shape('key' => 'a', 'url' => '/a', 'params' => []));
+        $this->object->get('a');
+        $this->object->flush();
+
+        $this->assertEquals(0, $this->object->getResults()->count());
+        $this->assertEquals(1, $this->object->getHits());
+    }
+
+    public function testHitRatioWithoutLookups(): void {
+        $this->assertEquals(0.0, $this->object->getHitRatio());
+    }
+
+}
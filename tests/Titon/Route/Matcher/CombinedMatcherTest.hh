@@ -0,0 +1,93 @@
+<?hh
+namespace Titon\Route\Matcher;
+
+use Titon\Route\Route;
+use Titon\Test\TestCase;
+use Titon\Utility\State\Server;
+
+/**
+ * @property \Titon\Route\Matcher\CombinedMatcher $object
+ */
+class CombinedMatcherTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->object = new CombinedMatcher(3);
+    }
+
+    public function testMatchesSameAsLoopMatcher(): void {
+        $build = () ==> Map {
+            'action.ext' => new Route('/{module}/{controller}/{action}.{ext}', 'Module\Controller@action'),
+            'action' => new Route('/{module}/{controller}/{action}', 'Module\Controller@action'),
+            'controller' => new Route('/{module}/{controller}', 'Module\Controller@action'),
+            'static' => new Route('/users/static', 'Module\Controller@action'),
+            'pattern' => (new Route('/code/<code>', 'Module\Controller@action'))->addPattern('code', '(?:[a-z]{3})'),
+            'module' => new Route('/{module}', 'Module\Controller@action'),
+            'optional' => new Route('/blog/[year?]/[month?]', 'Module\Controller@action'),
+            'wildcard' => new Route('/any/(path)', 'Module\Controller@action'),
+            'root' => new Route('/', 'Module\Controller@action')
+        };
+        $loop = new LoopMatcher();
+        $loopRoutes = $build();
+        $combinedRoutes = $build();
+
+        foreach (['/', '/users', '/users/', '/USERS/Profile', '/users/profile/view', '/users/profile/view.json', '/code/abc', '/blog/2015', '/blog/2015/10', '/any/$foo!', '/path~tilde', ''] as $url) {
+            $expected = $loop->match($url, $loopRoutes);
+            $actual = $this->object->match($url, $combinedRoutes);
+
+            if ($expected === null || $actual === null) {
+                $this->assertSame($expected, $actual, $url);
+            } else {
+                $this->assertEquals($expected->getPath(), $actual->getPath(), $url);
+                $this->assertSame($expected->getParams()->toArray(), $actual->getParams()->toArray(), $url);
+                $this->assertEquals($expected->url(), $actual->url(), $url);
+            }
+        }
+    }
+
+    public function testMatchSkipsRoutesThatCannotRespond(): void {
+        $post = (new Route('/form/{id}', 'Controller@action'))->addMethod('post');
+        $failed = (new Route('/form/{id}', 'Controller@action'))->addCondition($route ==> false);
+        $secure = (new Route('/form/{id}', 'Controller@action'))->setSecure(true);
+        $get = (new Route('/form/{id}', 'Controller@action'))->addMethod('get');
+        $routes = Map {'post' => $post, 'failed' => $failed, 'secure' => $secure, 'get' => $get};
+
+        $this->assertSame($get, $this->object->match('/form/1', $routes));
+        $this->assertEquals(Map {'id' => '1'}, $get->getParams());
+
+        $_SERVER['HTTPS'] = 'on';
+        Server::initialize($_SERVER);
+
+        $this->assertSame($secure, $this->object->match('/form/2', $routes));
+    }
+
+    public function testMatchDirectPath(): void {
+        $token = new Route('/{id}', 'Controller@action');
+        $routes = Map {'token' => $token};
+
+        $this->assertSame($token, $this->object->match('/{id}', $routes));
+        $this->assertEquals(Map {}, $token->getParams());
+    }
+
+    public function testMatchOptionalTrailingTokens(): void {
+        $route = new Route('/blog/[year?]/[month?]', 'Controller@action');
+        $routes = Map {'blog' => $route};
+
+        $this->assertSame($route, $this->object->match('/blog/2015', $routes));
+        $this->assertSame(['year' => '2015', 'month' => null], $route->getParams()->toArray());
+    }
+
+    public function testMatchLongestAlternativeWithMissingOptionalToken(): void {
+        $short = new Route('/foo/{id}', 'Controller@action');
+        $blog = new Route('/blog/[year?]/[month?]', 'Controller@action');
+        $routes = Map {'short' => $short, 'blog' => $blog};
+
+        $this->assertSame($blog, $this->object->match('/blog/2015', $routes));
+        $this->assertSame(['year' => '2015', 'month' => null], $blog->getParams()->toArray());
+
+        $this->assertSame($blog, $this->object->match('/blog', $routes));
+        $this->assertSame($short, $this->object->match('/foo/bar', $routes));
+    }
+
+}
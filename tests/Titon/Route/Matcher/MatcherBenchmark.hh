@@ -0,0 +1,79 @@
+<?hh
+namespace Titon\Route\Matcher;
+
+use Titon\Route\Matcher;
+use Titon\Route\Route;
+use Titon\Route\RouteMap;
+use Titon\Test\BenchmarkCase;
+use Titon\Utility\State\Server;
+
+class MatcherBenchmark extends BenchmarkCase {
+
+    public function setUp(): void {
+        Server::initialize(['REQUEST_METHOD' => 'GET']);
+    }
+
+    public function benchCombinedMatcher(): void {
+        foreach ([10, 100, 1000] as $count) {
+            $this->matchLast('CombinedMatcher', new CombinedMatcher(), $count);
+        }
+    }
+
+    public function benchLoopMatcher(): void {
+        foreach ([10, 100, 1000] as $count) {
+            $this->matchLast('LoopMatcher', new LoopMatcher(), $count);
+        }
+    }
+
+    public function benchTrieMatcher(): void {
+        foreach ([10, 100, 1000] as $count) {
+            $this->matchLast('TrieMatcher', new TrieMatcher(), $count);
+        }
+    }
+
+    protected function matchLast(string $name, Matcher $matcher, int $count): void {
+        $routes = $this->generateRoutes($count);
+
+        // Index of the last route generated for each type
+        $last = $type ==> $count - 1 - ((($count - 1) % 4 - $type + 4) % 4);
+
+        $urls = [
+            'static' => sprintf('/static-%s/page', $last(0)),
+            'token' => sprintf('/module-%s/users/123', $last(1)),
+            'optional' => sprintf('/optional-%s', $last(2)),
+            'pattern' => sprintf('/pattern-%s/abc', $last(3))
+        ];
+
+        foreach ($urls as $type => $url) {
+            $this->measure(sprintf('%s (%s routes, %s)', $name, $count, $type), 1000, () ==> {
+                invariant($matcher->match($url, $routes) !== null, 'Route must match.');
+            });
+        }
+    }
+
+    protected function generateRoutes(int $count): RouteMap {
+        $routes = Map {};
+
+        for ($i = 0; $i < $count; $i++) {
+            switch ($i % 4) {
+                case 0:
+                    $route = new Route(sprintf('/static-%s/page', $i), 'Controller@action');
+                break;
+                case 1:
+                    $route = new Route(sprintf('/module-%s/{controller}/[id]', $i), 'Controller@action');
+                break;
+                case 2:
+                    $route = new Route(sprintf('/optional-%s/{slug?}', $i), 'Controller@action');
+                break;
+                default:
+                    $route = (new Route(sprintf('/pattern-%s/<code>', $i), 'Controller@action'))->addPattern('code', '[a-z]{3}');
+                break;
+            }
+
+            $routes['route' . $i] = $route;
+        }
+
+        return $routes;
+    }
+
+}
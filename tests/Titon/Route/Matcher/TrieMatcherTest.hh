@@ -0,0 +1,151 @@
+<?hh
+namespace Titon\Route\Matcher;
+
+use Titon\Route\LocaleRoute;
+use Titon\Route\Route;
+use Titon\Test\TestCase;
+use Titon\Utility\State\Server;
+
+/**
+ * @property \Titon\Route\Matcher\TrieMatcher $object
+ */
+class TrieMatcherTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->object = new TrieMatcher();
+    }
+
+    public function testMatchesSameAsLoopMatcher(): void {
+        $build = () ==> Map {
+            'action.ext' => new Route('/{module}/{controller}/{action}.{ext}', 'Module\Controller@action'),
+            'action' => new Route('/{module}/{controller}/{action}', 'Module\Controller@action'),
+            'controller' => new Route('/{module}/{controller}', 'Module\Controller@action'),
+            'static' => new Route('/users/static', 'Module\Controller@action'),
+            'module' => new Route('/{module}', 'Module\Controller@action'),
+            'numeric' => new Route('/id/[id]', 'Module\Controller@action'),
+            'wildcard' => new Route('/any/(path)', 'Module\Controller@action'),
+            'root' => new Route('/', 'Module\Controller@action')
+        };
+        $loop = new LoopMatcher();
+        $loopRoutes = $build();
+        $trieRoutes = $build();
+
+        foreach (['/', '/users', '/users/', '/USERS/Profile', '/users/static', '/users/profile/view', '/users/profile/view.json', '/id/123', '/id/abc', '/any/$foo!', '/path~tilde', '', '//'] as $url) {
+            $expected = $loop->match($url, $loopRoutes);
+            $actual = $this->object->match($url, $trieRoutes);
+
+            if ($expected === null || $actual === null) {
+                $this->assertSame($expected, $actual, $url);
+            } else {
+                $this->assertEquals($expected->getPath(), $actual->getPath(), $url);
+                $this->assertEquals($expected->getParams(), $actual->getParams(), $url);
+                $this->assertEquals($expected->url(), $actual->url(), $url);
+            }
+        }
+    }
+
+    public function testMatchRespectsMappingOrder(): void {
+        $token = new Route('/users/{id}', 'Controller@action');
+        $static = new Route('/users/new', 'Controller@action');
+
+        $this->assertSame($token, $this->object->match('/users/new', Map {'token' => $token, 'static' => $static}));
+
+        $this->object->reset();
+
+        $this->assertSame($static, $this->object->match('/users/new', Map {'static' => $static, 'token' => $token}));
+    }
+
+    public function testMatchFallsBackToRegex(): void {
+        $pattern = (new Route('/<code>', 'Controller@action'))->addPattern('code', '[a-z]{3}');
+        $token = new Route('/{slug}', 'Controller@action');
+        $routes = Map {'pattern' => $pattern, 'token' => $token};
+
+        $this->assertSame($pattern, $this->object->match('/abc', $routes));
+        $this->assertEquals(Map {'code' => 'abc'}, $pattern->getParams());
+        $this->assertSame($token, $this->object->match('/abcd', $routes));
+        $this->assertEquals(Vector {0}, $this->object->getFallback());
+    }
+
+    public function testMatchRoutesThatRewriteTheirPath(): void {
+        $about = new LocaleRoute('/about', 'Controller@action');
+        $module = new LocaleRoute('/{module}', 'Controller@action');
+        $routes = Map {'about' => $about, 'module' => $module};
+
+        $this->assertSame($about, $this->object->match('/en/about', $routes));
+        $this->assertEquals(Map {'locale' => 'en'}, $about->getParams());
+        $this->assertSame($module, $this->object->match('/en-us/forum', $routes));
+        $this->assertEquals(null, $this->object->match('/about', $routes));
+        $this->assertEquals(Vector {0, 1}, $this->object->getFallback());
+    }
+
+    public function testMatchOptionalTokens(): void {
+        $route = new Route('/blog/[year?]/[month?]/{slug}', 'Controller@action');
+        $routes = Map {'blog' => $route};
+
+        $this->assertSame($route, $this->object->match('/blog/2015/10/hello', $routes));
+        $this->assertEquals(Map {'year' => '2015', 'month' => '10', 'slug' => 'hello'}, $route->getParams());
+
+        $this->assertSame($route, $this->object->match('/blog/2015/hello', $routes));
+        $this->assertEquals(Map {'year' => '2015', 'month' => '', 'slug' => 'hello'}, $route->getParams());
+
+        $this->assertSame($route, $this->object->match('/blog/hello', $routes));
+        $this->assertEquals(Map {'year' => '', 'month' => '', 'slug' => 'hello'}, $route->getParams());
+
+        $this->assertEquals(null, $this->object->match('/blog', $routes));
+    }
+
+    public function testMatchMethodAndSecure(): void {
+        $post = (new Route('/form', 'Controller@action'))->addMethod('post');
+        $secure = (new Route('/form', 'Controller@action'))->setSecure(true);
+        $get = (new Route('/form', 'Controller@action'))->addMethod('get');
+        $routes = Map {'post' => $post, 'secure' => $secure, 'get' => $get};
+
+        $this->assertSame($get, $this->object->match('/form', $routes));
+
+        $_SERVER['HTTPS'] = 'on';
+        Server::initialize($_SERVER);
+
+        $this->assertSame($secure, $this->object->match('/form', $routes));
+    }
+
+    public function testRoutesAreNotCompiledUntilMatched(): void {
+        $foo = new Route('/foo/{id}', 'Controller@action');
+        $bar = new Route('/bar/[id]', 'Controller@action');
+        $routes = Map {'foo' => $foo, 'bar' => $bar};
+
+        $this->assertSame($bar, $this->object->match('/bar/1', $routes));
+        $this->assertEquals(Map {'id' => '1'}, $bar->getParams());
+        $this->assertTrue($bar->isCompiled());
+        $this->assertFalse($foo->isCompiled());
+    }
+
+    public function testTrieIsCachedPerRouteMap(): void {
+        $foo = new Route('/foo', 'Controller@action');
+        $get = Map {'foo' => $foo};
+        $post = Map {'foo' => $foo};
+
+        $this->assertSame($foo, $this->object->match('/foo', $get));
+        $this->assertSame($foo, $this->object->match('/foo', $post));
+
+        // Switching between maps re-uses the previously built tries
+        $get['bar'] = new Route('/bar', 'Controller@action');
+
+        $this->assertEquals(null, $this->object->match('/bar', $post));
+        $this->assertEquals(null, $this->object->match('/bar', $get));
+    }
+
+    public function testTrieIsRebuiltWhenReset(): void {
+        $routes = Map {'foo' => new Route('/foo', 'Controller@action')};
+
+        $this->assertEquals(null, $this->object->match('/bar', $routes));
+
+        $routes['bar'] = new Route('/bar', 'Controller@action');
+
+        $this->object->reset();
+
+        $this->assertSame($routes['bar'], $this->object->match('/bar', $routes));
+    }
+
+}
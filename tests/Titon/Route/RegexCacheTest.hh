@@ -0,0 +1,60 @@
+<?hh
+namespace Titon\Route;
+
+use Titon\Test\TestCase;
+
+class RegexCacheTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        RegexCache::flush();
+    }
+
+    public function testCompileStoresResult(): void {
+        $route = (new Route('/regex-cache/[year]/<slug>', 'Controller@action'))->addPattern('slug', '[a-z\-]+');
+        $key = RegexCache::key($route);
+
+        $this->assertEquals(null, RegexCache::get($key));
+
+        $route->compile();
+
+        $this->assertEquals(shape(
+            'compiled' => '\/regex-cache\/([0-9\.]+)\/([a-z\-]+)\/?',
+            'patterns' => ['slug' => '[a-z\-]+'],
+            'static' => false,
+            'tokens' => [
+                shape('token' => 'slug', 'optional' => false),
+                shape('token' => 'year', 'optional' => false)
+            ]
+        ), RegexCache::get($key));
+    }
+
+    public function testCompileUsesCachedResult(): void {
+        $key = RegexCache::key(new Route('/regex-cache/{id}', 'Controller@action'));
+
+        RegexCache::set($key, shape(
+            'compiled' => '\/regex-cache\/(cached)\/?',
+            'patterns' => [],
+            'static' => false,
+            'tokens' => [shape('token' => 'id', 'optional' => false)]
+        ));
+
+        $route = new Route('/regex-cache/{id}', 'Controller@action');
+
+        $this->assertEquals('\/regex-cache\/(cached)\/?', $route->compile());
+        $this->assertEquals(Vector {shape('token' => 'id', 'optional' => false)}, $route->getTokens());
+        $this->assertTrue($route->isMatch('/regex-cache/cached'));
+    }
+
+    public function testKeyDiffersByState(): void {
+        $route = new Route('/users/<id>', 'Controller@action');
+        $key = RegexCache::key($route);
+
+        $this->assertEquals($key, RegexCache::key(new Route('/users/<id>', 'Controller@action')));
+        $this->assertNotEquals($key, RegexCache::key(new LocaleRoute('/users/<id>', 'Controller@action')));
+        $this->assertNotEquals($key, RegexCache::key(new Route('/user/<id>', 'Controller@action')));
+        $this->assertNotEquals($key, RegexCache::key($route->addPattern('id', '\d+')));
+    }
+
+}
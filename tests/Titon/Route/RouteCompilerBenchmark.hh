@@ -0,0 +1,41 @@
+<?hh
+namespace Titon\Route;
+
+use Titon\Test\BenchmarkCase;
+
+class RouteCompilerBenchmark extends BenchmarkCase {
+
+    protected string $path = '';
+
+    protected RouteMap $routes = Map {};
+
+    public function setUp(): void {
+        $this->path = TEMP_DIR . '/routes.compiled.hh';
+
+        for ($i = 0; $i < 500; $i++) {
+            $route = new Route(sprintf('/module-%s/{controller}/[id?]', $i), 'Controller@action');
+            $route->addMethod('get')->addFilter('auth');
+
+            $this->routes['route' . $i] = $route;
+        }
+
+        RouteCompiler::write($this->routes, $this->path);
+    }
+
+    public function tearDown(): void {
+        @unlink($this->path);
+    }
+
+    public function benchLoadRoutes(): void {
+        $serialized = serialize($this->routes);
+
+        $this->measure('unserialize (500 routes)', 100, () ==> {
+            unserialize($serialized);
+        });
+
+        $this->measure('RouteCompiler::load (500 routes)', 100, () ==> {
+            RouteCompiler::load($this->path);
+        });
+    }
+
+}
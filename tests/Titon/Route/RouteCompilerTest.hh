@@ -0,0 +1,71 @@
+<?hh
+namespace Titon\Route;
+
+use Titon\Test\TestCase;
+
+class RouteCompilerTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->vfs()->createDirectory('/routes/');
+    }
+
+    public function testCompile(): void {
+        $source = RouteCompiler::compile(Map {
+            'users' => (new Route('/users/[id]', 'Users@view'))->addMethod('GET')
+        });
+
+        $this->assertStringStartsWith('<?hh', $source);
+        $this->assertContains("'compiled' => '\\\\/users\\\\/([0-9\\\\.]+)\\\\/?'", $source);
+    }
+
+    /**
+     * @expectedException \Titon\Route\Exception\UnexportableRouteException
+     */
+    public function testCompileErrorsForCallbackRoutes(): void {
+        RouteCompiler::compile(Map {'callback' => new CallbackRoute('/', () ==> 'foo')});
+    }
+
+    public function testWriteAndLoad(): void {
+        $path = $this->vfs()->path('/routes/compiled.hh');
+        $routes = Map {
+            'users' => (new Route('/users/[id]', 'Users@view'))->addMethod('GET')->addFilter('auth'),
+            'blog' => (new Route('/blog/<slug>', 'Blog@read'))->addPattern('slug', '[a-z\-]+')->setSecure(true),
+            'about' => (new Route('/about', 'Pages@about'))->setStatic(true)
+        };
+
+        $this->assertTrue(RouteCompiler::write($routes, $path));
+
+        $loaded = RouteCompiler::load($path);
+
+        $this->assertEquals(Vector {'users', 'blog', 'about'}, $loaded->keys());
+
+        foreach ($routes as $key => $route) {
+            $this->assertEquals($route->export(), $loaded[$key]->export());
+            $this->assertInstanceOf('Titon\Route\Route', $loaded[$key]);
+        }
+
+        $this->assertTrue($loaded['users']->isMatch('/users/123'));
+        $this->assertEquals(Map {'id' => '123'}, $loaded['users']->getParams());
+        $this->assertEquals(shape('class' => 'Blog', 'action' => 'read'), $loaded['blog']->getAction());
+    }
+
+    public function testRouterLoadCompiled(): void {
+        $path = $this->vfs()->path('/routes/compiled.hh');
+        $router = new Router();
+
+        RouteCompiler::write(Map {
+            'about' => new Route('/about', 'Pages@about'),
+            'page' => new Route('/page/{slug}', 'Pages@view')
+        }, $path);
+
+        $router->loadCompiled($path);
+
+        $this->assertTrue($router->isCached());
+        $this->assertEquals(Map {'/about' => Vector {'about'}}, $router->getStaticRoutes());
+        $this->assertEquals('/about', $router->match('/about')->getPath());
+        $this->assertEquals('/page/{slug}', $router->match('/page/foo')->getPath());
+    }
+
+}
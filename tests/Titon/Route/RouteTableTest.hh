@@ -0,0 +1,80 @@
+<?hh
+namespace Titon\Route;
+
+use Titon\Test\TestCase;
+use Titon\Utility\State\Server;
+
+/**
+ * @property \Titon\Route\RouteTable $object
+ */
+class RouteTableTest extends TestCase {
+
+    protected function setUp(): void {
+        parent::setUp();
+
+        $this->object = RouteTable::fromRoutes(Map {
+            'post' => (new Route('/form', 'Controller@action'))->addMethod('post'),
+            'secure' => (new Route('/form', 'Controller@action'))->setSecure(true),
+            'module' => new Route('/{module}/[id?]', 'Controller@action'),
+            'token' => new Route('/{id}', 'Controller@action')
+        });
+    }
+
+    /**
+     * @expectedException \Titon\Route\Exception\UnexportableRouteException
+     */
+    public function testFromRoutesWithConditions(): void {
+        RouteTable::fromRoutes(Map {
+            'token' => (new Route('/{id}', 'Controller@action'))->addCondition($route ==> false)
+        });
+    }
+
+    public function testGetKey(): void {
+        $route = $this->object->getRoute('token');
+
+        invariant($route !== null, 'Route must exist.');
+
+        $this->assertEquals('token', $this->object->getKey($route));
+        $this->assertEquals(null, $this->object->getKey(new Route('/{id}', 'Controller@action')));
+    }
+
+    public function testGetRoute(): void {
+        $route = $this->object->getRoute('module');
+
+        $this->assertInstanceOf('Titon\Route\Route', $route);
+        $this->assertSame($route, $this->object->getRoute('module'));
+        $this->assertEquals('/{module}/[id?]', $route?->getPath());
+        $this->assertEquals(null, $this->object->getRoute('missing'));
+    }
+
+    public function testMatch(): void {
+        $route = $this->object->match('/users/5');
+
+        $this->assertEquals('/{module}/[id?]', $route?->getPath());
+        $this->assertEquals(Map {'module' => 'users', 'id' => '5'}, $route?->getParams());
+        $this->assertEquals('/users/5', $route?->url());
+
+        // Only the matched route is created
+        $this->assertEquals(Vector {'module'}, $this->object->getRoutes()->keys());
+
+        // Direct path comparison
+        $this->assertEquals('/{id}', $this->object->match('/{id}')?->getPath());
+
+        $this->assertEquals(null, $this->object->match('/a/b/c'));
+    }
+
+    public function testMatchMethodAndSecure(): void {
+        $this->assertEquals('/{module}/[id?]', $this->object->match('/form')?->getPath());
+
+        $_SERVER['HTTPS'] = 'on';
+        Server::initialize($_SERVER);
+
+        $this->assertSame($this->object->getRoute('secure'), $this->object->match('/form'));
+
+        $_SERVER['REQUEST_METHOD'] = 'POST';
+        Server::initialize($_SERVER);
+
+        $this->assertSame($this->object->getRoute('post'), $this->object->match('/form'));
+    }
+
+}
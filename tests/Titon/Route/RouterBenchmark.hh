@@ -0,0 +1,140 @@
+<?hh
+namespace Titon\Route;
+
+use Titon\Cache\Storage\MemoryStorage;
+use Titon\Route\Event\MatchingEvent;
+use Titon\Test\BenchmarkCase;
+use Titon\Utility\State\Server;
+
+class RouterBenchmark extends BenchmarkCase {
+
+    public function setUp(): void {
+        Server::initialize([
+            'HTTP_HOST' => 'localhost',
+            'DOCUMENT_ROOT' => '/root',
+            'SCRIPT_FILENAME' => '/root/index.php',
+            'REQUEST_URI' => '/',
+            'REQUEST_METHOD' => 'GET',
+            'SERVER_PORT' => 80,
+            'HTTPS' => 'off'
+        ]);
+
+        RegexCache::flush();
+    }
+
+    public function benchCompile(): void {
+        $paths = [
+            'static' => '/about/company',
+            'token' => '/{module}/{controller}/[id]',
+            'optional' => '/blog/[year?]/[month?]/[day?]',
+            'pattern' => '/code/<code>'
+        ];
+
+        foreach ($paths as $type => $path) {
+            $this->measure(sprintf('Route::compile() cold (%s)', $type), 1000, () ==> {
+                RegexCache::flush();
+
+                (new Route($path, 'Controller@action'))->addPattern('code', '[a-z]{3}')->compile();
+            });
+
+            $this->measure(sprintf('Route::compile() cached (%s)', $type), 1000, () ==> {
+                (new Route($path, 'Controller@action'))->addPattern('code', '[a-z]{3}')->compile();
+            });
+        }
+    }
+
+    public function benchLoadRoutes(): void {
+        foreach ([100, 1000] as $count) {
+            $storage = new MemoryStorage();
+            $router = $this->generateRouter($count);
+            $router->setStorage($storage);
+            $router->match('/about-0');
+
+            $this->measure(sprintf('Router::doLoadRoutes() (%s routes)', $count), 100, () ==> {
+                $loader = new Router();
+                $loader->setStorage($storage);
+                $loader->doLoadRoutes(new MatchingEvent($loader, '/'));
+            });
+        }
+    }
+
+    public function benchMatch(): void {
+        foreach ([100, 1000] as $count) {
+            $router = $this->generateRouter($count);
+            $last = (int) ($count / 10) - 1;
+
+            $urls = [
+                'first static' => '/about-0',
+                'last static' => sprintf('/about-%s', $last),
+                'last token' => sprintf('/module-%s/users/123', $last),
+                'last optional' => sprintf('/blog-%s/2015', $last),
+                'last pattern' => sprintf('/code-%s/abc', $last),
+                'last group' => sprintf('/admin-%s/users/edit/123', $last),
+                'last resource' => sprintf('/api-%s/users/123', $last)
+            ];
+
+            foreach ($urls as $type => $url) {
+                $this->measure(sprintf('Router::match() (%s routes, %s)', $count, $type), 1000, () ==> {
+                    $router->match($url);
+                });
+            }
+
+            $router->setMatchCache(new MatchCache());
+
+            $this->measure(sprintf('Router::match() cached (%s routes, last token)', $count), 1000, () ==> {
+                $router->match(sprintf('/module-%s/users/123', $last));
+            });
+        }
+    }
+
+    public function benchUrlBuilder(): void {
+        $router = $this->generateRouter(100);
+        $builder = new UrlBuilder($router);
+        $params = Map {'controller' => 'users', 'id' => 123};
+        $list = Vector {};
+
+        for ($i = 0; $i < 100; $i++) {
+            $list[] = Map {'controller' => 'users', 'id' => $i};
+        }
+
+        $this->measure('UrlBuilder::build()', 1000, () ==> {
+            $builder->build('module.9', $params);
+        });
+
+        $this->measure('UrlBuilder::build() x100', 100, () ==> {
+            foreach ($list as $item) {
+                $builder->build('module.9', $item);
+            }
+        });
+
+        $this->measure('UrlBuilder::buildMany() x100', 100, () ==> {
+            $builder->buildMany('module.9', $list);
+        });
+    }
+
+    /**
+     * Generate a router with a mix of route types. Every 10 routes contains a static, tokenized, optional,
+     * pattern, and grouped route, and a resource that expands into 5 routes.
+     */
+    protected function generateRouter(int $count): Router {
+        $router = new Router();
+
+        for ($i = 0; $i < $count / 10; $i++) {
+            $router->map('about.' . $i, new Route(sprintf('/about-%s', $i), 'Controller@action'));
+            $router->map('module.' . $i, new Route(sprintf('/module-%s/{controller}/[id]', $i), 'Controller@action'));
+            $router->map('blog.' . $i, new Route(sprintf('/blog-%s/[year?]/[month?]', $i), 'Controller@action'));
+            $router->map('code.' . $i, (new Route(sprintf('/code-%s/<code>', $i), 'Controller@action'))->addPattern('code', '[a-z]{3}'));
+
+            $router->group(($router, $group) ==> {
+                $group->setPrefix(sprintf('/admin-%s', $i));
+
+                $router->map('admin.' . $i, new Route('/{controller}/edit/[id]', 'Controller@action'));
+            });
+
+            $router->resource('api.' . $i, new Route(sprintf('/api-%s/users', $i), 'Users@action'));
+        }
+
+        return $router;
+    }
+
+}
@@ -2,6 +2,7 @@
 namespace Titon\Route;
 
 use Titon\Cache\Storage\MemoryStorage;
+use Titon\Route\Matcher\TrieMatcher;
 use Titon\Test\Stub\Route\FilterStub;
 use Titon\Test\Stub\Route\TestRouteStub;
 use Titon\Test\TestCase;
@@ -74,6 +75,76 @@ class RouterTest extends TestCase {
         $this->assertEquals('/', $router2->getRoute('root')->getPath());
     }
 
+    public function testCachingKeepsMatchCache(): void {
+        $cache = new MatchCache();
+
+        $this->object->setStorage(new MemoryStorage());
+        $this->object->setMatchCache($cache);
+
+        $route = $this->object->match('/users');
+
+        $this->assertTrue($this->object->isCached());
+        $this->assertSame($route, $this->object->match('/users'));
+        $this->assertEquals(1, $cache->getHits());
+        $this->assertEquals(1, $cache->getMisses());
+    }
+
+    public function testCachingSharedTable(): void {
+        $storage = new MemoryStorage();
+
+        $router1 = new Router();
+        $router1->setStorage($storage);
+        $router1->setShared(true);
+        $router1->map('module', new Route('/{module}', 'Module\Controller@action'));
+        $router1->map('root', new Route('/', 'Module\Controller@action'));
+        $router1->match('/');
+
+        $this->assertFalse($storage->has('routes'));
+        $this->assertTrue(is_array($storage->get('routes.table')));
+
+        // Now load another instance
+        $router2 = new Router();
+        $router2->setStorage($storage);
+        $router2->setShared(true);
+
+        $route = $router2->match('/users');
+
+        $this->assertTrue($router2->isCached());
+        $this->assertEquals('/{module}', $route->getPath());
+        $this->assertEquals(Map {'module' => 'users'}, $route->getParams());
+        $this->assertInstanceOf('Titon\Route\RouteTable', $router2->getTable());
+        $this->assertEquals(Vector {'module'}, $router2->getTable()?->getRoutes()?->keys());
+        $this->assertSame($route, $router2->getRoute('module'));
+        $this->assertEquals('/', $router2->getRoute('root')->getPath());
+    }
+
+    public function testCachingSharedFallsBackToSerializingWithConditions(): void {
+        $storage = new MemoryStorage();
+
+        $router1 = new Router();
+        $router1->setStorage($storage);
+        $router1->setShared(true);
+        $router1->map('module', (new Route('/{module}', 'Module\Controller@action'))->addCondition($route ==> true));
+        $router1->map('root', new Route('/', 'Module\Controller@action'));
+        $router1->match('/');
+
+        $this->assertTrue($router1->isCached());
+        $this->assertFalse($storage->has('routes.table'));
+        $this->assertTrue($storage->has('routes'));
+
+        // Now load another instance
+        $router2 = new Router();
+        $router2->setStorage($storage);
+        $router2->setShared(true);
+
+        $route = $router2->match('/users');
+
+        $this->assertTrue($router2->isCached());
+        $this->assertEquals(null, $router2->getTable());
+        $this->assertEquals('/{module}', $route->getPath());
+        $this->assertEquals(Map {'module' => 'users'}, $route->getParams());
+    }
+
     public function testFilters(): void {
         $stub = new FilterStub();
 
@@ -344,6 +415,98 @@ class RouterTest extends TestCase {
         $this->object->match('/path~tilde');
     }
 
+    public function testMatchCache(): void {
+        $cache = new MatchCache();
+        $condition = (new Route('/condition/{id}', 'Controller@action'))->addCondition($route ==> true);
+
+        $this->object->setMatchCache($cache);
+        $this->object->map('condition', $condition);
+
+        $route = $this->object->match('/users/profile');
+
+        $this->assertEquals(Map {'module' => 'users', 'controller' => 'profile'}, $route->getParams());
+        $this->assertEquals(0, $cache->getHits());
+        $this->assertEquals(1, $cache->getMisses());
+
+        // Reset the params to verify they are restored
+        $route->match(['/foo/bar', 'foo', 'bar']);
+
+        $this->assertSame($route, $this->object->match('/users/profile'));
+        $this->assertEquals(Map {'module' => 'users', 'controller' => 'profile'}, $route->getParams());
+        $this->assertEquals('/users/profile', $route->url());
+        $this->assertEquals(1, $cache->getHits());
+
+        // Routes with conditions are not cached
+        $this->object->match('/condition/1');
+        $this->object->match('/condition/1');
+
+        $this->assertEquals(1, $cache->getHits());
+        $this->assertEquals(Vector {'get http://localhost/users/profile'}, $cache->getResults()->keys());
+
+        // Mapping a route flushes the cache
+        $this->object->map('profile', new Route('/users/profile', 'Controller@action'));
+
+        $this->assertEquals(0, $cache->getResults()->count());
+        $this->assertEquals('/users/profile', $this->object->match('/users/profile')->getPath());
+    }
+
+    public function testMatchCacheSkipsRoutesAfterConditions(): void {
+        $cache = new MatchCache();
+        $enabled = Vector {false};
+
+        $this->object->getRoutes()->clear();
+        $this->object->setMatchCache($cache);
+
+        $feature = $this->object->map('feature', new Route('/{feature}', 'Controller@action'))->addCondition($route ==> $enabled[0]);
+        $page = $this->object->map('page', new Route('/{page}', 'Controller@action'));
+
+        $this->assertSame($page, $this->object->match('/foo'));
+        $this->assertEquals(0, $cache->getResults()->count());
+
+        // The earlier route wins once its condition passes
+        $enabled[0] = true;
+
+        $this->assertSame($feature, $this->object->match('/foo'));
+        $this->assertEquals(0, $cache->getResults()->count());
+    }
+
+    public function testMethodRoutes(): void {
+        $this->object->getRoutes()->clear();
+
+        $any = $this->object->map('any', new Route('/any/{id}', 'Controller@action'));
+        $post = $this->object->post('post', new Route('/post/{id}', 'Controller@action'));
+        $get = $this->object->map('get', new Route('/get/{id}', 'Controller@action'))->addMethod('GET');
+        $both = $this->object->http('both', Vector {'get', 'post'}, new Route('/both/{id}', 'Controller@action'));
+
+        $this->assertEquals(Vector {'any', 'get', 'both'}, $this->object->getMethodRoutes('GET')->keys());
+        $this->assertEquals(Vector {'any', 'post', 'both'}, $this->object->getMethodRoutes('post')->keys());
+        $this->assertEquals(Vector {'any'}, $this->object->getMethodRoutes('put')->keys());
+
+        $this->assertSame($get, $this->object->match('/get/1'));
+        $this->assertSame($both, $this->object->match('/both/1'));
+
+        // Buckets are rebuilt when a route is mapped
+        $put = $this->object->put('put', new Route('/put/{id}', 'Controller@action'));
+
+        $this->assertEquals(Vector {'any', 'put'}, $this->object->getMethodRoutes('put')->keys());
+
+        $_SERVER['REQUEST_METHOD'] = 'POST';
+        Server::initialize($_SERVER);
+
+        $this->assertSame($post, $this->object->match('/post/1'));
+        $this->assertSame($any, $this->object->match('/any/1'));
+    }
+
+    public function testMatcherIsResetWhenMapping(): void {
+        $this->object->setMatcher(new TrieMatcher());
+
+        $this->assertEquals('/{module}', $this->object->match('/users')->getPath());
+
+        $this->object->map('module', new Route('/{slug}', 'Controller@action'));
+
+        $this->assertEquals('/{slug}', $this->object->match('/users')->getPath());
+    }
+
     public function testParseAction(): void {
         $this->assertEquals(shape(
             'class' => 'Controller',
@@ -496,6 +659,57 @@ class RouterTest extends TestCase {
         $this->object->getRoute('fakeKey');
     }
 
+    public function testStaticRouteIndex(): void {
+        $this->object->getRoutes()->clear();
+
+        $health = new Route('/health', 'Controller@action');
+        $post = (new Route('/api/v1/status', 'Controller@action'))->addMethod('post');
+        $get = (new Route('/api/v1/status', 'Controller@action'))->addMethod('get');
+
+        $this->object->map('health', $health);
+        $this->object->map('status.post', $post);
+        $this->object->map('status.get', $get);
+        $this->object->map('locale', new LocaleRoute('/about', 'Controller@action'));
+        $this->object->map('module', new Route('/{module}', 'Controller@action'));
+
+        $this->assertEquals(Map {
+            '/health' => Vector {'health'},
+            '/api/v1/status' => Vector {'status.post', 'status.get'}
+        }, $this->object->getStaticRoutes());
+
+        $this->assertSame($health, $this->object->match('/health'));
+        $this->assertSame($health, $this->object->match('/HEALTH/'));
+        $this->assertEquals(Map {}, $health->getParams());
+
+        // Only answers for the current method
+        $this->assertSame($get, $this->object->match('/api/v1/status'));
+
+        // Falls through to the matcher
+        $this->assertEquals('/{module}', $this->object->match('/about')->getPath());
+    }
+
+    public function testStaticRouteIndexRespectsMappingOrder(): void {
+        $this->object->getRoutes()->clear();
+
+        $id = $this->object->map('users.id', new Route('/users/[id]', 'Controller@action'));
+        $new = $this->object->map('users.new', new Route('/users/new', 'Controller@action'));
+
+        // Mapped before the literal route, but can not match its path
+        $this->assertSame($new, $this->object->match('/users/new'));
+        $this->assertSame($id, $this->object->match('/users/1'));
+        $this->assertEquals(Vector {'/users/new'}, $this->object->getStaticRoutes()->keys());
+
+        // Literal routes that are shadowed by an earlier route are left to the matcher
+        $slug = $this->object->map('blog.slug', new Route('/blog/{slug}', 'Controller@action'));
+        $this->object->map('blog.new', new Route('/blog/new', 'Controller@action'));
+        $module = $this->object->map('module', new Route('/{module}', 'Controller@action'));
+        $this->object->map('health', new Route('/health', 'Controller@action'));
+
+        $this->assertSame($slug, $this->object->match('/blog/new'));
+        $this->assertSame($module, $this->object->match('/health'));
+        $this->assertEquals(Vector {'/users/new'}, $this->object->getStaticRoutes()->keys());
+    }
+
     public function testWireClassMapping(): void {
         $this->object->wire('Titon\Test\Stub\Route\RouteAnnotatedStub');
 
@@ -49,6 +49,34 @@ class UrlBuilderTest extends TestCase {
         $this->assertEquals('/users/profile/feed.json', $this->object->build('action.ext', Map {'module' => 'users', 'controller' => 'profile', 'action' => 'feed', 'ext' => 'json'}));
     }
 
+    public function testBuildMany(): void {
+        $this->assertEquals(Vector {
+            '/users/profile/feed.json?page=2',
+            '/posts/comment/list.xml?page=2'
+        }, $this->object->buildMany('action.ext', Vector {
+            Map {'module' => 'users', 'controller' => 'profile', 'action' => 'feed', 'ext' => 'json'},
+            Map {'module' => 'Posts', 'controller' => 'comment', 'action' => 'list', 'ext' => 'xml'}
+        }, Map {'page' => 2}));
+
+        $this->assertEquals(Vector {}, $this->object->buildMany('module', Vector {}));
+    }
+
+    /**
+     * @expectedException \Titon\Route\Exception\MissingTokenException
+     */
+    public function testBuildManyMissingToken(): void {
+        $this->object->buildMany('module', Vector {Map {'module' => 'users'}, Map {}});
+    }
+
+    public function testBuildDoesNotModifyArguments(): void {
+        $params = Map {'module' => 'users'};
+        $query = Map {'#' => 'foobar'};
+
+        $this->assertEquals('/users#foobar', $this->object->build('module', $params, $query));
+        $this->assertEquals(Map {'module' => 'users'}, $params);
+        $this->assertEquals(Map {'#' => 'foobar'}, $query);
+    }
+
     public function testBuildQueryString(): void {
         $this->assertEquals('/users?foo=bar', $this->object->build('module', Map {'module' => 'users'}, Map {'foo' => 'bar'}));
         $this->assertEquals('/users?foo=bar&baz%5B0%5D=1&baz%5B1%5D=2&baz%5B2%5D=3', $this->object->build('module', Map {'module' => 'users'}, Map {'foo' => 'bar', 'baz' => Vector{1, 2, 3}}));
@@ -117,6 +145,24 @@ class UrlBuilderTest extends TestCase {
         $this->object->build('module');
     }
 
+    public function testGetTemplate(): void {
+        $this->object->getRouter()->map('blog.archives', new TestRouteStub('/blog/[year]/(slug)/{page?}', 'Module\Controller@action'));
+
+        $template = $this->object->getTemplate('blog.archives');
+
+        $this->assertEquals(['/blog/', '/', '/', ''], $template['chunks']);
+        $this->assertEquals([
+            shape('token' => 'year', 'optional' => false),
+            shape('token' => 'slug', 'optional' => false),
+            shape('token' => 'page', 'optional' => true)
+        ], $template['tokens']);
+
+        // Rebuilt when the route is re-mapped
+        $this->object->getRouter()->map('blog.archives', new TestRouteStub('/archives/[year]', 'Module\Controller@action'));
+
+        $this->assertEquals(['/archives/', ''], $this->object->getTemplate('blog.archives')['chunks']);
+    }
+
     public function testGetAbsoluteUrl(): void {
         $_SERVER['DOCUMENT_ROOT'] = '/root';
         $_SERVER['HTTP_HOST'] = 'sub.domain.com';
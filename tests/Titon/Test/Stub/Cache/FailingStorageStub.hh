@@ -0,0 +1,59 @@
+<?hh // strict
+namespace Titon\Test\Stub\Cache;
+
+use Titon\Cache\Exception\CorruptedItemException;
+use Titon\Cache\Item;
+use Titon\Cache\StatsMap;
+use Titon\Cache\Storage\MemoryStorage;
+use Titon\Cache\ValueMap;
+use \RuntimeException;
+
+class FailingStorageStub extends MemoryStorage {
+    public bool $corrupted = false;
+
+    public bool $down = false;
+
+    public function getItem(string $key): Item {
+        $this->fail();
+
+        if ($this->corrupted) {
+            throw new CorruptedItemException('Item is corrupted');
+        }
+
+        return parent::getItem($key);
+    }
+
+    public function getMany(array<string> $keys): ValueMap {
+        $this->fail();
+
+        return parent::getMany($keys);
+    }
+
+    public function has(string $key): bool {
+        $this->fail();
+
+        return parent::has($key);
+    }
+
+    public function set(string $key, mixed $value, int $expires): bool {
+        $this->fail();
+
+        return parent::set($key, $value, $expires);
+    }
+
+    public function stats(): StatsMap {
+        $stats = parent::stats();
+        $hits = (int) $stats[self::HITS];
+        $lookups = $hits + (int) $stats[self::MISSES];
+
+        $stats[self::HIT_RATIO] = $lookups ? round($hits / $lookups, 4) : 0.0;
+
+        return $stats;
+    }
+
+    protected function fail(): void {
+        if ($this->down) {
+            throw new RuntimeException('Node is down');
+        }
+    }
+}
@@ -177,6 +177,22 @@ CFG;
         $this->assertFalse(Config::has('debug.email'));
     }
 
+    public function testRevision(): void {
+        $revision = Config::revision();
+
+        Config::get('app.name');
+        $this->assertEquals($revision, Config::revision());
+
+        Config::set('app.name', 'TestName');
+        $this->assertEquals($revision + 1, Config::revision());
+
+        Config::remove('app.name');
+        $this->assertEquals($revision + 2, Config::revision());
+
+        Config::flush();
+        $this->assertEquals($revision + 3, Config::revision());
+    }
+
     public function testSalt(): void {
         $this->assertEquals(Config::salt(), $this->app['salt']);
 
@@ -0,0 +1,116 @@
+<?hh
+/**
+ * @copyright   2010-2015, The Titon Project
+ * @license     http://opensource.org/licenses/bsd-license.php
+ * @link        http://titon.io
+ */
+
+// Set timezone for benchmarks
+date_default_timezone_set('UTC');
+
+// Set benchmark constants
+define('TEST_DIR', __DIR__);
+define('TEMP_DIR', TEST_DIR . '/tmp');
+define('VENDOR_DIR', dirname(TEST_DIR) . '/vendor');
+define('SRC_DIR', dirname(TEST_DIR) . '/src');
+define('DS', DIRECTORY_SEPARATOR);
+
+// Start autoloader
+if (!file_exists(VENDOR_DIR . '/autoload.php')) {
+    exit('Please install Composer in the root folder before running benchmarks!');
+}
+
+require VENDOR_DIR . '/autoload.php';
+
+// Parse arguments, results are output as a table unless --json is passed
+$target = '';
+$json = false;
+
+foreach (array_slice($argv, 1) as $arg) {
+    if ($arg === '--json') {
+        $json = true;
+    } else {
+        $target = $arg;
+    }
+}
+
+// Find all benchmarks within the defined path
+$path = realpath(TEST_DIR . '/' . $target);
+$files = [];
+
+if (!$path) {
+    exit('Invalid benchmark path.');
+
+} else if (is_file($path)) {
+    $files[] = $path;
+
+} else {
+    foreach (new RecursiveIteratorIterator(new RecursiveDirectoryIterator($path)) as $file) {
+        if (substr($file->getFilename(), -13) === 'Benchmark.hh') {
+            $files[] = $file->getPathname();
+        }
+    }
+
+    sort($files);
+}
+
+// Run each benchmark method and output the results
+$report = [];
+
+foreach ($files as $file) {
+    $class = str_replace('/', '\\', substr($file, strlen(TEST_DIR . '/'), -3));
+    $benchmark = new $class();
+
+    foreach (get_class_methods($benchmark) as $method) {
+        if (substr($method, 0, 5) !== 'bench') {
+            continue;
+        }
+
+        $benchmark->setUp();
+        $benchmark->$method();
+        $benchmark->tearDown();
+    }
+
+    if (!$json) {
+        echo $class . PHP_EOL;
+    }
+
+    foreach ($benchmark->getResults() as $result) {
+        $opsPerSec = $result['iterations'] / max($result['time'], 0.000001);
+        $msPerOp = ($result['time'] / $result['iterations']) * 1000;
+
+        if ($json) {
+            $report[] = [
+                'class' => $class,
+                'name' => $result['name'],
+                'iterations' => $result['iterations'],
+                'time' => $result['time'],
+                'opsPerSec' => $opsPerSec,
+                'msPerOp' => $msPerOp,
+                'memory' => $result['memory'],
+                'peakMemory' => $result['peakMemory']
+            ];
+        } else {
+            printf("  %-50s %10d ops %12.2f ops/sec %10.3f ms/op %10d bytes\n",
+                $result['name'],
+                $result['iterations'],
+                $opsPerSec,
+                $msPerOp,
+                $result['memory']);
+        }
+    }
+
+    if (!$json) {
+        echo PHP_EOL;
+    }
+}
+
+// Output a single document that can be saved and diffed between versions
+if ($json) {
+    echo json_encode([
+        'hhvm' => defined('HHVM_VERSION') ? HHVM_VERSION : null,
+        'php' => PHP_VERSION,
+        'date' => date('c'),
+        'results' => $report
+    ], JSON_PRETTY_PRINT) . PHP_EOL;
+}